@@ -10,6 +10,9 @@
 
 #define NUM_THREADS 8
 
+//Side length of the square leaf blocks stored contiguously in the Morton layout
+#define MORTON_LEAF 32
+
 using namespace std::chrono;
 using namespace std;
 
@@ -122,6 +125,7 @@ int getMenuChoice()
     cout << "1. Serial" << endl;
     cout << "2. Pthread" << endl;
     cout << "3. OpenMP" << endl;
+    cout << "4. Cache-Oblivious (Morton layout, OpenMP tasks)" << endl;
     cout << "0. Exit" << endl;
     cout << "Enter choice: ";
     
@@ -498,6 +502,212 @@ void runOpenMP(double **A, double **B, double **C)
     writeMatricesToFile(A, B, C, N, "OpenMP");
 }
 
+//CACHE-OBLIVIOUS IMPLEMENTATION SECTION -------------------------------------------------------------------------------------------------------------------------------------------
+
+//Structure to hold a matrix stored in Morton (Z-order) blocks
+//The matrix is padded up to blocks_per_side * MORTON_LEAF, where blocks_per_side is a power of two.
+//Each MORTON_LEAF x MORTON_LEAF leaf block is stored row-major, and the leaf blocks are laid out in Z-order,
+//so every quadrant at every level of the recursion is one contiguous range of memory.
+struct mortonMatrix
+{
+    double *data;
+    int size;
+    int blocks_per_side;
+};
+
+//Function to interleave the bits of a block row and block column into a Morton index
+long long mortonIndex(int block_row, int block_col)
+{
+    long long index = 0;
+    for (int bit = 0; bit < 16; bit++)
+    {
+        index |= (long long)((block_col >> bit) & 1) << (2 * bit);
+        index |= (long long)((block_row >> bit) & 1) << (2 * bit + 1);
+    }
+    return index;
+}
+
+//Function to allocate a zeroed Morton matrix large enough to hold a size x size matrix
+mortonMatrix allocateMortonMatrix(int size)
+{
+    mortonMatrix matrix;
+    matrix.size = size;
+    matrix.blocks_per_side = 1;
+    while (matrix.blocks_per_side * MORTON_LEAF < size)
+    {
+        matrix.blocks_per_side *= 2;
+    }
+
+    long long elements = (long long)matrix.blocks_per_side * matrix.blocks_per_side * MORTON_LEAF * MORTON_LEAF;
+    matrix.data = (double*)calloc(elements, sizeof(double));
+    return matrix;
+}
+
+//Function to free a Morton matrix
+void freeMortonMatrix(mortonMatrix &matrix)
+{
+    free(matrix.data);
+    matrix.data = NULL;
+}
+
+//Function to convert a row-major matrix into the Morton layout (padding stays zero)
+void toMortonLayout(double **source, mortonMatrix &matrix, int num_threads)
+{
+    int size = matrix.size;
+
+    #pragma omp parallel for num_threads(num_threads)
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            long long block = mortonIndex(i / MORTON_LEAF, j / MORTON_LEAF);
+            matrix.data[block * MORTON_LEAF * MORTON_LEAF + (i % MORTON_LEAF) * MORTON_LEAF + (j % MORTON_LEAF)] = source[i][j];
+        }
+    }
+}
+
+//Function to convert a Morton matrix back into the row-major layout
+void fromMortonLayout(const mortonMatrix &matrix, double **destination, int num_threads)
+{
+    int size = matrix.size;
+
+    #pragma omp parallel for num_threads(num_threads)
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            long long block = mortonIndex(i / MORTON_LEAF, j / MORTON_LEAF);
+            destination[i][j] = matrix.data[block * MORTON_LEAF * MORTON_LEAF + (i % MORTON_LEAF) * MORTON_LEAF + (j % MORTON_LEAF)];
+        }
+    }
+}
+
+//Function to multiply-accumulate a single pair of leaf blocks (C += A * B)
+void multiplyLeafBlock(const double *A, const double *B, double *C)
+{
+    for (int i = 0; i < MORTON_LEAF; i++)
+    {
+        for (int k = 0; k < MORTON_LEAF; k++)
+        {
+            double a = A[i * MORTON_LEAF + k];
+            for (int j = 0; j < MORTON_LEAF; j++)
+            {
+                C[i * MORTON_LEAF + j] += a * B[k * MORTON_LEAF + j];
+            }
+        }
+    }
+}
+
+//Recursive cache-oblivious multiply-accumulate (C += A * B) over Morton matrices of blocks x blocks leaf blocks
+//Quadrants are numbered in Z-order: 0 = top left, 1 = top right, 2 = bottom left, 3 = bottom right.
+//The eight quadrant products are done in two rounds of four, so no two tasks ever write the same quadrant of C.
+void multiplyMortonRecursive(const double *A, const double *B, double *C, int blocks)
+{
+    if (blocks == 1)
+    {
+        multiplyLeafBlock(A, B, C);
+        return;
+    }
+
+    int half = blocks / 2;
+    long long quadrant = (long long)half * half * MORTON_LEAF * MORTON_LEAF;
+
+    //Only spawn tasks while each quadrant is still large enough to be worth it
+    bool spawn = half >= 2;
+
+    const double *A00 = A, *A01 = A + quadrant, *A10 = A + 2 * quadrant, *A11 = A + 3 * quadrant;
+    const double *B00 = B, *B01 = B + quadrant, *B10 = B + 2 * quadrant, *B11 = B + 3 * quadrant;
+    double *C00 = C, *C01 = C + quadrant, *C10 = C + 2 * quadrant, *C11 = C + 3 * quadrant;
+
+    #pragma omp task if(spawn)
+    multiplyMortonRecursive(A00, B00, C00, half);
+    #pragma omp task if(spawn)
+    multiplyMortonRecursive(A00, B01, C01, half);
+    #pragma omp task if(spawn)
+    multiplyMortonRecursive(A10, B00, C10, half);
+    #pragma omp task if(spawn)
+    multiplyMortonRecursive(A10, B01, C11, half);
+    #pragma omp taskwait
+
+    #pragma omp task if(spawn)
+    multiplyMortonRecursive(A01, B10, C00, half);
+    #pragma omp task if(spawn)
+    multiplyMortonRecursive(A01, B11, C01, half);
+    #pragma omp task if(spawn)
+    multiplyMortonRecursive(A11, B10, C10, half);
+    #pragma omp task if(spawn)
+    multiplyMortonRecursive(A11, B11, C11, half);
+    #pragma omp taskwait
+}
+
+//Cache-oblivious matrix multiplication over Morton matrices
+void matrixMultiplyCacheOblivious(const mortonMatrix &A, const mortonMatrix &B, mortonMatrix &C, int num_threads)
+{
+    long long elements = (long long)C.blocks_per_side * C.blocks_per_side * MORTON_LEAF * MORTON_LEAF;
+    for (long long i = 0; i < elements; i++)
+    {
+        C.data[i] = 0.0;
+    }
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        #pragma omp single
+        multiplyMortonRecursive(A.data, B.data, C.data, C.blocks_per_side);
+    }
+}
+
+//Function to run the cache-oblivious implementation
+void runCacheOblivious(double **A, double **B, double **C)
+{
+    int num_threads = getThreadCount();
+
+    mortonMatrix mortonA = allocateMortonMatrix(N);
+    mortonMatrix mortonB = allocateMortonMatrix(N);
+    mortonMatrix mortonC = allocateMortonMatrix(N);
+
+    cout << "\nCache-Oblivious Implementation" << endl;
+    cout << "Matrix size: " << N << "x" << N << " (padded to " << mortonC.blocks_per_side * MORTON_LEAF << "x" << mortonC.blocks_per_side * MORTON_LEAF << ")" << endl;
+    cout << "Threads: " << num_threads << endl;
+
+    long long durations[10];
+
+    for (int run = 0; run < 10; run++)
+    {
+        initialiseMatrixOpenMP(A, N, num_threads);
+        initialiseMatrixOpenMP(B, N, num_threads);
+
+        //Layout conversion is timed as well, so the result is comparable with the row-major implementations
+        auto start = high_resolution_clock::now();
+        toMortonLayout(A, mortonA, num_threads);
+        toMortonLayout(B, mortonB, num_threads);
+        matrixMultiplyCacheOblivious(mortonA, mortonB, mortonC, num_threads);
+        fromMortonLayout(mortonC, C, num_threads);
+        auto stop = high_resolution_clock::now();
+
+        auto duration = duration_cast<microseconds>(stop - start);
+        durations[run] = duration.count();
+    }
+
+    for (int i = 0; i < 10; i++)
+    {
+        cout << "Run " << (i + 1) << " - Time taken: " << formatWithCommas(durations[i]) << " microseconds" << endl;
+    }
+
+    long long total_time = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        total_time += durations[i];
+    }
+    double average = (double)total_time / 10.0;
+    cout << "Average time over 10 runs: " << formatWithCommas((long long)average) << " microseconds" << endl;
+
+    writeMatricesToFile(A, B, C, N, "CacheOblivious");
+
+    freeMortonMatrix(mortonA);
+    freeMortonMatrix(mortonB);
+    freeMortonMatrix(mortonC);
+}
+
 //MAIN FUNCTION -------------------------------------------------------------------------------------------------------------------------------------------------------
 
 int main(int argc, char* argv[])
@@ -546,6 +756,9 @@ int main(int argc, char* argv[])
             case 3:
                 runOpenMP(A, B, C);
                 break;
+            case 4:
+                runCacheOblivious(A, B, C);
+                break;
             case 0:
                 cout << "Exiting..." << endl;
                 break;
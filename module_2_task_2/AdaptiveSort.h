@@ -0,0 +1,381 @@
+#ifndef ADAPTIVE_SORT_H
+#define ADAPTIVE_SORT_H
+
+#include <omp.h>
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include "SortEngine.h"
+#include "MergeSort.h"
+
+//Run-detecting adaptive merge sort in the TimSort / powersort style, for inputs that arrive mostly sorted.
+//1. The array is scanned in parallel for natural runs: non-decreasing runs, and strictly decreasing runs which are
+//   reversed in place (strict, so reversing them keeps equal elements in order)
+//2. Runs shorter than ADAPTIVE_MIN_RUN are extended to that length with insertion sort
+//3. The runs are merged along the powersort merge tree, which keeps the merges balanced by length whatever the run
+//   lengths are. Independent subtrees are merged in parallel and the big merges near the root use merge path
+//When the scan finds no real structure (runs averaging under ADAPTIVE_MIN_RUN elements) the array is left untouched
+//and adaptiveSort returns false so the caller can use a sort that doesn't depend on order, like the parallel QuickSort.
+//Like the merge sort it is stable.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Natural runs shorter than this are extended with insertion sort, and inputs whose runs average under this many
+//elements are treated as having no structure
+const int ADAPTIVE_MIN_RUN = 32;
+
+//Structure to hold one run, array[start..end - 1]
+struct adaptiveRun
+{
+    std::ptrdiff_t start;
+    std::ptrdiff_t end;
+    bool descending;
+};
+
+//Structure to hold the powersort merge tree over the runs
+//Node b is the boundary between runs[b] and runs[b + 1], and merges everything to its left in its subtree with
+//everything to its right. The tree is the Cartesian tree of the boundary powers, so the root has the smallest power.
+struct runMergeTree
+{
+    std::vector<adaptiveRun> runs;
+    std::vector<int> left;          //Left child of each boundary, -1 when the left side is a single run
+    std::vector<int> right;         //Right child of each boundary, -1 when the right side is a single run
+    int root;                       //-1 when there is only one run
+};
+
+//Structure to hold one subtree of the merge tree, covering runs[first..last]
+struct runSubtree
+{
+    int node;
+    int first;
+    int last;
+};
+
+//RUN DETECTION SECTION ---------------------------------------------------------------------
+
+//Function to append the natural runs of array[start..end - 1] to runs
+//The runs found are added to totalRuns in batches, and the scan gives up early once every chunk together has found
+//more than maxRuns, since the caller will then fall back to another sort anyway. Returns false if it gave up, in
+//which case the runs stop partway through the chunk.
+template <typename T, typename Less>
+inline bool findRuns(const T array[], std::ptrdiff_t start, std::ptrdiff_t end, std::vector<adaptiveRun> &runs, std::atomic<long long> &totalRuns, long long maxRuns, Less less)
+{
+    const int batch = 256;
+    std::ptrdiff_t i = start;
+    while (i < end)
+    {
+        std::ptrdiff_t j = i + 1;
+        bool descending = (j < end && less(array[j], array[j - 1]));
+        if (descending)
+        {
+            while (j < end && less(array[j], array[j - 1]))
+            {
+                j++;
+            }
+        }
+        else
+        {
+            while (j < end && !less(array[j], array[j - 1]))
+            {
+                j++;
+            }
+        }
+        runs.push_back({i, j, descending});
+        i = j;
+
+        if (runs.size() % batch == 0 && (totalRuns += batch) > maxRuns)
+        {
+            return false;
+        }
+    }
+    totalRuns += runs.size() % batch;
+    return true;
+}
+
+//Function to find the natural runs of array[0..size - 1] with one chunk per thread
+//Runs that were cut at a chunk boundary are joined back together when the boundary continues them.
+//Returns false (with the runs incomplete) as soon as it is certain there are more than maxRuns runs, or when any chunk
+//gave up early, since its runs then don't cover the array.
+template <typename T, typename Less>
+inline bool scanRuns(const T array[], std::ptrdiff_t size, std::vector<adaptiveRun> &runs, long long maxRuns, Less less)
+{
+    int chunks = (size > MERGE_SORT_PARALLEL_CUTOFF) ? omp_get_max_threads() : 1;
+    std::vector<std::vector<adaptiveRun>> chunkRuns(chunks);
+    std::atomic<long long> totalRuns(0);
+    std::atomic<bool> complete(true);
+
+    #pragma omp parallel for num_threads(chunks) schedule(static)
+    for (int chunk = 0; chunk < chunks; chunk++)
+    {
+        std::ptrdiff_t start = size * chunk / chunks;
+        std::ptrdiff_t end = size * (chunk + 1) / chunks;
+        if (!findRuns(array, start, end, chunkRuns[chunk], totalRuns, maxRuns, less))
+        {
+            complete = false;
+        }
+    }
+
+    //Joining runs across the chunk boundaries removes at most chunks - 1 of them
+    if (!complete || totalRuns > maxRuns + chunks - 1)
+    {
+        return false;
+    }
+
+    runs.clear();
+    for (int chunk = 0; chunk < chunks; chunk++)
+    {
+        for (size_t r = 0; r < chunkRuns[chunk].size(); r++)
+        {
+            adaptiveRun run = chunkRuns[chunk][r];
+            if (r == 0 && !runs.empty() && runs.back().descending == run.descending)
+            {
+                bool continues = run.descending ? less(array[run.start], array[run.start - 1]) : !less(array[run.start], array[run.start - 1]);
+                if (continues)
+                {
+                    runs.back().end = run.end;
+                    continue;
+                }
+            }
+            runs.push_back(run);
+        }
+    }
+    return (long long)runs.size() <= maxRuns;
+}
+
+//Function to reverse every descending run in place
+//Long runs are reversed by the whole team, short ones are shared out between the threads.
+template <typename T>
+inline void reverseDescendingRuns(T array[], std::vector<adaptiveRun> &runs)
+{
+    std::vector<int> shortRuns;
+    for (size_t r = 0; r < runs.size(); r++)
+    {
+        if (!runs[r].descending)
+        {
+            continue;
+        }
+        std::ptrdiff_t start = runs[r].start;
+        std::ptrdiff_t length = runs[r].end - start;
+        if (length > MERGE_SORT_PARALLEL_CUTOFF)
+        {
+            #pragma omp parallel for schedule(static)
+            for (std::ptrdiff_t i = 0; i < length / 2; i++)
+            {
+                std::swap(array[start + i], array[start + length - 1 - i]);
+            }
+        }
+        else
+        {
+            shortRuns.push_back((int)r);
+        }
+        runs[r].descending = false;
+    }
+
+    int numShort = (int)shortRuns.size();
+    #pragma omp parallel for schedule(dynamic, 64) if (numShort > 64)
+    for (int s = 0; s < numShort; s++)
+    {
+        std::reverse(array + runs[shortRuns[s]].start, array + runs[shortRuns[s]].end);
+    }
+}
+
+//Function to replace the (ascending) natural runs with runs of at least ADAPTIVE_MIN_RUN elements
+//A short run is extended over the start of the runs after it with insertion sort, which only moves the elements that
+//are out of place, and whatever is left of the run it cut into carries on as the next run.
+template <typename T, typename Less>
+inline void extendShortRuns(T array[], std::ptrdiff_t size, std::vector<adaptiveRun> &runs, Less less)
+{
+    std::vector<adaptiveRun> extended;
+    size_t r = 0;
+    std::ptrdiff_t start = 0;
+    while (start < size)
+    {
+        while (runs[r].end <= start)
+        {
+            r++;
+        }
+        std::ptrdiff_t end = runs[r].end;
+        if (end - start < ADAPTIVE_MIN_RUN && end < size)
+        {
+            end = std::min<std::ptrdiff_t>(size, start + ADAPTIVE_MIN_RUN);
+            insertionSort(array, start, end - 1, less);
+        }
+        extended.push_back({start, end, false});
+        start = end;
+    }
+    runs.swap(extended);
+}
+
+//MERGE TREE SECTION ------------------------------------------------------------------------
+
+//Function to return the powersort power of the boundary between a run of n1 elements starting at s1 and the run of n2
+//elements after it, in an array of n elements
+//The power is the first bit where the two runs' midpoints (as fractions of n) differ, so boundaries near the middle
+//of the array get small powers and are merged last.
+inline int runBoundaryPower(long long s1, long long n1, long long n2, long long n)
+{
+    long long a = 2 * s1 + n1;
+    long long b = a + n1 + n2;
+    int power = 0;
+    while (true)
+    {
+        power++;
+        if (a >= n)
+        {
+            a -= n;
+            b -= n;
+        }
+        else if (b >= n)
+        {
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+    return power;
+}
+
+//Function to build the powersort merge tree over tree.runs for an array of size elements
+inline void buildRunMergeTree(runMergeTree &tree, std::ptrdiff_t size)
+{
+    int boundaries = (int)tree.runs.size() - 1;
+    tree.left.assign(std::max(0, boundaries), -1);
+    tree.right.assign(std::max(0, boundaries), -1);
+
+    std::vector<int> powers(std::max(0, boundaries));
+    std::vector<int> stack;
+    for (int b = 0; b < boundaries; b++)
+    {
+        const adaptiveRun &run = tree.runs[b];
+        powers[b] = runBoundaryPower(run.start, run.end - run.start, tree.runs[b + 1].end - run.end, size);
+
+        //Boundaries with a higher power than this one are merged before it, so they go in its left subtree
+        int last = -1;
+        while (!stack.empty() && powers[stack.back()] > powers[b])
+        {
+            last = stack.back();
+            stack.pop_back();
+        }
+        tree.left[b] = last;
+        if (!stack.empty())
+        {
+            tree.right[stack.back()] = b;
+        }
+        stack.push_back(b);
+    }
+    tree.root = stack.empty() ? -1 : stack[0];
+}
+
+//MERGE SECTION -----------------------------------------------------------------------------
+
+//Function to stably merge the adjacent sorted ranges array[low..mid - 1] and array[mid..high - 1]
+//The left elements not greater than array[mid] and the right elements not less than array[mid - 1] are already in
+//place and are skipped, which is what makes small perturbations cheap. With parallel set, big merges copy both sides
+//to scratch and merge back with merge path, otherwise only the left side is copied and merged back sequentially.
+template <typename T, typename Less>
+inline void mergeAdjacentRuns(T array[], T scratch[], std::ptrdiff_t low, std::ptrdiff_t mid, std::ptrdiff_t high, bool parallel, Less less)
+{
+    if (!less(array[mid], array[mid - 1]))
+    {
+        return;
+    }
+    low = (std::upper_bound(array + low, array + mid, array[mid], less) - array);
+    high = (std::lower_bound(array + mid, array + high, array[mid - 1], less) - array);
+
+    if (parallel && high - low > MERGE_SORT_PARALLEL_CUTOFF && omp_get_max_threads() > 1)
+    {
+        #pragma omp parallel for schedule(static)
+        for (std::ptrdiff_t i = low; i < high; i++)
+        {
+            scratch[i] = array[i];
+        }
+        parallelMerge(scratch + low, mid - low, scratch + mid, high - mid, array + low, less);
+    }
+    else
+    {
+        //Writing into array[low..] never overtakes the right side still being read, so only the left side needs copying
+        std::copy(array + low, array + mid, scratch + low);
+        sequentialMerge(scratch + low, mid - low, array + mid, high - mid, array + low, less);
+    }
+}
+
+//Function to merge every run in the subtree sequentially
+template <typename T, typename Less>
+inline void mergeRunSubtree(T array[], T scratch[], const runMergeTree &tree, const runSubtree &subtree, Less less)
+{
+    if (subtree.node < 0)
+    {
+        return;
+    }
+    int b = subtree.node;
+    mergeRunSubtree(array, scratch, tree, {tree.left[b], subtree.first, b}, less);
+    mergeRunSubtree(array, scratch, tree, {tree.right[b], b + 1, subtree.last}, less);
+    mergeAdjacentRuns(array, scratch, tree.runs[subtree.first].start, tree.runs[b].end, tree.runs[subtree.last].end, false, less);
+}
+
+//Function to split the tree into subtrees of at most grain elements (the frontier, in array order) and the merges
+//above them (in post-order, so each comes after both of its children)
+inline void splitRunMergeTree(const runMergeTree &tree, const runSubtree &subtree, std::ptrdiff_t grain, std::vector<runSubtree> &frontier, std::vector<runSubtree> &upper)
+{
+    std::ptrdiff_t count = tree.runs[subtree.last].end - tree.runs[subtree.first].start;
+    if (subtree.node < 0 || count <= grain)
+    {
+        frontier.push_back(subtree);
+        return;
+    }
+    int b = subtree.node;
+    splitRunMergeTree(tree, {tree.left[b], subtree.first, b}, grain, frontier, upper);
+    splitRunMergeTree(tree, {tree.right[b], b + 1, subtree.last}, grain, frontier, upper);
+    upper.push_back(subtree);
+}
+
+//ADAPTIVE SORT SECTION ---------------------------------------------------------------------
+
+//Function to stably sort array[0..size - 1] by merging its natural runs, using omp_get_max_threads() threads
+//Returns false without touching the array when the runs average under ADAPTIVE_MIN_RUN elements, in which case the
+//caller should sort it some other way. scratchBuffer works as for parallelStableSort.
+template <typename T, typename Less = std::less<T>>
+inline bool adaptiveSort(T array[], std::ptrdiff_t size, Less less = Less(), mergeScratchBuffer<T> *scratchBuffer = NULL)
+{
+    if (size < 2)
+    {
+        return true;
+    }
+
+    runMergeTree tree;
+    if (!scanRuns(array, size, tree.runs, size / ADAPTIVE_MIN_RUN, less))
+    {
+        return false;
+    }
+
+    reverseDescendingRuns(array, tree.runs);
+    extendShortRuns(array, size, tree.runs, less);
+    buildRunMergeTree(tree, size);
+
+    //Subtrees below the grain are merged by one thread each, the bigger merges above them by the whole team
+    mergeScratchBuffer<T> ownBuffer;
+    T *scratch = reserveMergeScratch(scratchBuffer != NULL ? *scratchBuffer : ownBuffer, size);
+    int threads = omp_get_max_threads();
+    std::ptrdiff_t grain = std::max<std::ptrdiff_t>(MERGE_SORT_PARALLEL_CUTOFF, size / (threads * 4));
+    std::vector<runSubtree> frontier;
+    std::vector<runSubtree> upper;
+    splitRunMergeTree(tree, {tree.root, 0, (int)tree.runs.size() - 1}, grain, frontier, upper);
+
+    int numFrontier = (int)frontier.size();
+    #pragma omp parallel for schedule(dynamic) if (numFrontier > 1 && threads > 1)
+    for (int f = 0; f < numFrontier; f++)
+    {
+        mergeRunSubtree(array, scratch, tree, frontier[f], less);
+    }
+
+    for (size_t u = 0; u < upper.size(); u++)
+    {
+        int b = upper[u].node;
+        mergeAdjacentRuns(array, scratch, tree.runs[upper[u].first].start, tree.runs[b].end, tree.runs[upper[u].last].end, true, less);
+    }
+    return true;
+}
+
+#endif
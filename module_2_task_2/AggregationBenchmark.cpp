@@ -0,0 +1,187 @@
+#include <iostream>
+#include <cstdlib>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <omp.h>
+#include "SampleSort.h"
+#include "MergeSort.h"
+#include "GroupBy.h"
+#include "Distributions.h"
+
+using namespace std::chrono;
+using namespace std;
+
+//Function to format numbers with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    //Insert commas from right to left
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Row to aggregate: a key and the value summed, minimized and maximized per key
+struct keyValue
+{
+    int key;
+    int value;
+};
+
+//Function to check the sort-based aggregates against the hash map ones
+bool sameAggregates(const vector<keyAggregate<int, int>> &groups, const unordered_map<int, keyAggregate<int, int>> &expected)
+{
+    if (groups.size() != expected.size())
+    {
+        return false;
+    }
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        auto found = expected.find(groups[g].key);
+        if (found == expected.end() || found->second.count != groups[g].count || found->second.sum != groups[g].sum
+            || found->second.min != groups[g].min || found->second.max != groups[g].max)
+        {
+            return false;
+        }
+        if (g > 0 && !(groups[g - 1].key < groups[g].key))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//Main function that calls other functions
+//10,000,000 (key, value) rows are aggregated per key by sorting them (stable parallel merge sort) and scanning the
+//runs with parallelGroupByKey, and by a sequential unordered_map for comparison. The distinct keys are counted by
+//sorting the keys with the samplesort and running parallelCountDistinct, against an unordered_set. Every run checks
+//the two answers agree.
+int main()
+{
+    string filename = "AggregationBenchmarkResults.txt";
+    ofstream outfile(filename);
+    if (!outfile.is_open())
+    {
+        cout << "Error: Could not create output file " << filename << endl;
+        return 1;
+    }
+
+    const ptrdiff_t size = 10000000;
+    const int numRuns = 3;
+
+    outfile << "---------------------------------------------" << endl;
+    outfile << "Aggregation Benchmark Results" << endl;
+    outfile << "Threads: " << omp_get_max_threads() << ", Rows: " << formatWithCommas(size) << ", averaged over " << numRuns << " runs" << endl;
+    outfile << "---------------------------------------------" << endl;
+    outfile << endl;
+
+    cout << "Starting Aggregation Benchmark" << endl;
+    cout << "Threads: " << omp_get_max_threads() << endl;
+    cout << endl;
+
+    InputDistribution distributions[] = {DIST_FEW_UNIQUE, DIST_ZIPF, DIST_RANDOM};
+    int numDistributions = sizeof(distributions) / sizeof(distributions[0]);
+
+    outfile << "| Keys | Groups | Sort + Group By (us) | Hash Map (us) | Sort + Count Distinct (us) | Hash Set (us) |" << endl;
+    outfile << "|------|--------|----------------------|---------------|----------------------------|---------------|" << endl;
+
+    srand(time(0));
+    vector<int> keys(size);
+    vector<int> values(size);
+    vector<keyValue> rows(size);
+    mergeScratchBuffer<keyValue> rowScratch;
+
+    for (int d = 0; d < numDistributions; d++)
+    {
+        InputDistribution distribution = distributions[d];
+        cout << "Testing keys: " << distributionName(distribution) << endl;
+
+        long long groupTime = 0, mapTime = 0, distinctTime = 0, setTime = 0;
+        ptrdiff_t numGroups = 0;
+        bool correct = true;
+
+        for (int run = 0; run < numRuns; run++)
+        {
+            generateDistribution(keys.data(), size, distribution, ((unsigned long long)rand() << 31) | rand());
+            generateDistribution(values.data(), size, DIST_RANDOM, ((unsigned long long)rand() << 31) | rand());
+
+            //Group by: sort the rows by key, then aggregate the runs
+            for (ptrdiff_t i = 0; i < size; i++)
+            {
+                rows[i] = {keys[i], values[i]};
+            }
+            auto start = high_resolution_clock::now();
+            parallelStableSort(rows.data(), size, [](const keyValue &a, const keyValue &b) { return a.key < b.key; }, &rowScratch);
+            vector<keyAggregate<int, int>> groups = parallelGroupByKey(rows.data(), size,
+                [](const keyValue &row) { return row.key; }, [](const keyValue &row) { return row.value; });
+            auto stop = high_resolution_clock::now();
+            groupTime += duration_cast<microseconds>(stop - start).count();
+            numGroups = (ptrdiff_t)groups.size();
+
+            start = high_resolution_clock::now();
+            unordered_map<int, keyAggregate<int, int>> map;
+            for (ptrdiff_t i = 0; i < size; i++)
+            {
+                auto inserted = map.emplace(keys[i], keyAggregate<int, int>{keys[i], 0, 0, values[i], values[i]});
+                keyAggregate<int, int> &group = inserted.first->second;
+                group.count++;
+                group.sum += values[i];
+                group.min = min(group.min, values[i]);
+                group.max = max(group.max, values[i]);
+            }
+            stop = high_resolution_clock::now();
+            mapTime += duration_cast<microseconds>(stop - start).count();
+            correct = correct && sameAggregates(groups, map);
+
+            //Count distinct: the hash set goes first, the sort below reorders keys
+            start = high_resolution_clock::now();
+            unordered_set<int> set(keys.begin(), keys.end());
+            stop = high_resolution_clock::now();
+            setTime += duration_cast<microseconds>(stop - start).count();
+
+            start = high_resolution_clock::now();
+            sampleSort(keys.data(), size);
+            ptrdiff_t distinct = parallelCountDistinct(keys.data(), size);
+            stop = high_resolution_clock::now();
+            distinctTime += duration_cast<microseconds>(stop - start).count();
+            correct = correct && distinct == (ptrdiff_t)set.size() && distinct == numGroups;
+        }
+
+        if (!correct)
+        {
+            outfile << distributionName(distribution) << " keys: the sort-based and hash-based answers differ" << endl;
+            cout << "  The sort-based and hash-based answers differ" << endl;
+        }
+
+        outfile << "| " << distributionName(distribution) << " | " << formatWithCommas(numGroups) << " | " << formatWithCommas(groupTime / numRuns)
+                << " | " << formatWithCommas(mapTime / numRuns) << " | " << formatWithCommas(distinctTime / numRuns)
+                << " | " << formatWithCommas(setTime / numRuns) << " |" << endl;
+        cout << "  Groups: " << formatWithCommas(numGroups) << ", sort + group by: " << formatWithCommas(groupTime / numRuns)
+             << " us, hash map: " << formatWithCommas(mapTime / numRuns) << " us, sort + count distinct: "
+             << formatWithCommas(distinctTime / numRuns) << " us, hash set: " << formatWithCommas(setTime / numRuns) << " us" << endl;
+    }
+
+    outfile << endl;
+    outfile.close();
+    cout << "\nResults written to: " << filename << endl;
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#ifndef ARRAY_STORAGE_H
+#define ARRAY_STORAGE_H
+
+#include <iostream>
+#include <string>
+#include <new>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+//Backing memory for the benchmark arrays, so sorts of several billion elements can run on large-memory machines.
+//Besides the normal heap an array can live in huge pages (2 MB pages cut the TLB misses of a random access pass over
+//tens of GB) or in a file mapped into memory, which lets the kernel page it out to disk instead of failing when the
+//array and its scratch buffer don't both fit in RAM.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Where an array's memory comes from, chosen on the command line
+enum ArrayBacking
+{
+    BACKING_HEAP,           //new[]
+    BACKING_HUGE_PAGES,     //Anonymous mmap with explicit huge pages, or transparent huge pages if none are reserved
+    BACKING_FILE            //Shared mmap of a file that is removed again when the array is freed
+};
+
+//Size of a huge page, mappings with MAP_HUGETLB are rounded up to a multiple of it
+const size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+//Structure to hold one allocated array and what is needed to release it
+struct arrayStorage
+{
+    int *data;
+    size_t bytes;                   //Bytes mapped (rounded up to whole huge pages for MAP_HUGETLB)
+    ArrayBacking backing;
+    bool explicitHugePages;         //True when MAP_HUGETLB succeeded, false when it fell back to transparent huge pages
+    std::string path;               //Backing file for BACKING_FILE
+};
+
+//Function to return the display name of a backing
+inline const char* arrayBackingName(ArrayBacking backing)
+{
+    switch (backing)
+    {
+        case BACKING_HUGE_PAGES:
+            return "Huge pages";
+        case BACKING_FILE:
+            return "File-backed mmap";
+        default:
+            return "Heap";
+    }
+}
+
+//ALLOCATION SECTION ------------------------------------------------------------------------
+
+//Function to allocate size ints with the given backing, path is only used for BACKING_FILE
+//Returns false (with an error printed) if the memory could not be allocated.
+inline bool allocateArrayStorage(arrayStorage &storage, std::ptrdiff_t size, ArrayBacking backing, const std::string &path)
+{
+    storage.data = NULL;
+    storage.bytes = (size_t)size * sizeof(int);
+    storage.backing = backing;
+    storage.explicitHugePages = false;
+    storage.path = path;
+
+    if (backing == BACKING_HEAP)
+    {
+        storage.data = new (std::nothrow) int[size];
+        if (storage.data == NULL)
+        {
+            std::cout << "Error: Could not allocate " << storage.bytes << " bytes" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void *memory = MAP_FAILED;
+    if (backing == BACKING_HUGE_PAGES)
+    {
+        //Explicit huge pages need pages reserved in /proc/sys/vm/nr_hugepages, otherwise ask for transparent ones
+        size_t hugeBytes = (storage.bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+        memory = mmap(NULL, hugeBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED)
+        {
+            storage.bytes = hugeBytes;
+            storage.explicitHugePages = true;
+        }
+        else
+        {
+            memory = mmap(NULL, storage.bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory != MAP_FAILED)
+            {
+                madvise(memory, storage.bytes, MADV_HUGEPAGE);
+            }
+        }
+    }
+    else
+    {
+        int descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (descriptor < 0)
+        {
+            std::cout << "Error: Could not create backing file " << path << std::endl;
+            return false;
+        }
+        if (ftruncate(descriptor, (off_t)storage.bytes) == 0)
+        {
+            memory = mmap(NULL, storage.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        }
+        //The mapping keeps the file open, the descriptor is no longer needed
+        close(descriptor);
+        if (memory == MAP_FAILED)
+        {
+            unlink(path.c_str());
+        }
+    }
+
+    if (memory == MAP_FAILED)
+    {
+        std::cout << "Error: Could not map " << storage.bytes << " bytes (" << arrayBackingName(backing) << ")" << std::endl;
+        return false;
+    }
+    storage.data = (int*)memory;
+    return true;
+}
+
+//Function to release an array allocated with allocateArrayStorage (removing its backing file)
+inline void freeArrayStorage(arrayStorage &storage)
+{
+    if (storage.data == NULL)
+    {
+        return;
+    }
+    if (storage.backing == BACKING_HEAP)
+    {
+        delete[] storage.data;
+    }
+    else
+    {
+        munmap(storage.data, storage.bytes);
+        if (storage.backing == BACKING_FILE)
+        {
+            unlink(storage.path.c_str());
+        }
+    }
+    storage.data = NULL;
+}
+
+#endif
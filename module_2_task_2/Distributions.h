@@ -0,0 +1,192 @@
+#ifndef DISTRIBUTIONS_H
+#define DISTRIBUTIONS_H
+
+#include <omp.h>
+#include <cmath>
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <algorithm>
+
+//Parallel input generator for the sort benchmarks.
+//Every element is computed from a hash of (seed, index) instead of a shared rand() state, so the threads can fill
+//their parts of the array independently and the same seed gives the same array whatever the thread count.
+//Arrays of more than 2^31 elements are supported: the index based distributions divide their values down so they
+//still fit in an int, which keeps them in order but makes neighbouring elements equal.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Input distributions the generator can produce
+enum InputDistribution
+{
+    DIST_RANDOM,            //Uniform 31-bit values, like rand()
+    DIST_SORTED,            //0, 1, 2, ...
+    DIST_REVERSE,           //size, size - 1, ...
+    DIST_NEARLY_SORTED,     //Sorted with 1% of the elements swapped within their block
+    DIST_FEW_UNIQUE,        //Uniform over only FEW_UNIQUE_VALUES values
+    DIST_ORGAN_PIPE,        //Ascending to the middle, then descending
+    DIST_ZIPF,              //Zipf skewed (exponent 1): value r turns up about 1 / r as often as value 1
+    DIST_GAUSSIAN,          //Normal around 2^30 with a standard deviation of 2^26
+    DIST_MEDIAN3_KILLER,    //Musser's sequence that makes a first / middle / last median-of-three pivot quadratic
+    DIST_COUNT
+};
+
+//Number of distinct values in the few unique distribution
+const int FEW_UNIQUE_VALUES = 16;
+
+//The nearly sorted swaps stay within blocks of this size so the blocks can be perturbed in parallel
+const int NEARLY_SORTED_BLOCK = 65536;
+
+//Function to return the display name of a distribution (also used in results file names)
+inline const char* distributionName(InputDistribution distribution)
+{
+    switch (distribution)
+    {
+        case DIST_SORTED:
+            return "Sorted";
+        case DIST_REVERSE:
+            return "Reverse";
+        case DIST_NEARLY_SORTED:
+            return "NearlySorted";
+        case DIST_FEW_UNIQUE:
+            return "FewUnique";
+        case DIST_ORGAN_PIPE:
+            return "OrganPipe";
+        case DIST_ZIPF:
+            return "Zipf";
+        case DIST_GAUSSIAN:
+            return "Gaussian";
+        case DIST_MEDIAN3_KILLER:
+            return "Median3Killer";
+        default:
+            return "Random";
+    }
+}
+
+//Function to find the distribution with the given command line name (its display name in lower case),
+//returns false if there is none
+inline bool parseDistribution(const std::string &option, InputDistribution &distribution)
+{
+    for (int d = 0; d < DIST_COUNT; d++)
+    {
+        std::string name = distributionName((InputDistribution)d);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == option)
+        {
+            distribution = (InputDistribution)d;
+            return true;
+        }
+    }
+    return false;
+}
+
+//GENERATOR SECTION -------------------------------------------------------------------------
+
+//Function to hash (seed, index) into 64 random bits (splitmix64)
+inline unsigned long long distributionHash(unsigned long long seed, long long index)
+{
+    unsigned long long z = seed + (unsigned long long)(index + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+//Function to turn a hash into a uniform double in [0, 1)
+inline double hashToUnit(unsigned long long hash)
+{
+    return (hash >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//Function to return element i of Musser's median-of-three killer for size elements
+//The first half alternates small odd values with large values and the second half holds the even values, so a
+//first / middle / last median-of-three keeps picking the second smallest element as the pivot.
+inline std::ptrdiff_t medianOfThreeKiller(std::ptrdiff_t i, std::ptrdiff_t size)
+{
+    std::ptrdiff_t k = size / 2;
+    if (i >= 2 * k)
+    {
+        return size;
+    }
+    if (i >= k)
+    {
+        return 2 * (i - k + 1);
+    }
+    return (i % 2 == 0) ? i + 1 : k + i;
+}
+
+//Function to return the divisor that brings index based values for size elements into int range (1 up to 2^31 elements)
+inline std::ptrdiff_t distributionScale(std::ptrdiff_t size)
+{
+    return size / 2147483648LL + 1;
+}
+
+//Function to return element i of the given distribution, before any nearly sorted swaps
+inline int distributionValue(InputDistribution distribution, std::ptrdiff_t i, std::ptrdiff_t size, unsigned long long seed)
+{
+    unsigned long long hash = distributionHash(seed, i);
+    std::ptrdiff_t scale = distributionScale(size);
+    switch (distribution)
+    {
+        case DIST_SORTED:
+        case DIST_NEARLY_SORTED:
+            return (int)(i / scale);
+        case DIST_REVERSE:
+            return (int)((size - i) / scale);
+        case DIST_FEW_UNIQUE:
+            return (int)(hash % FEW_UNIQUE_VALUES);
+        case DIST_ORGAN_PIPE:
+            return (int)(((i < size / 2) ? i : size - i) / scale);
+        case DIST_ZIPF:
+        {
+            //Inverse of the continuous CDF ln(r) / ln(size + 1), a density of 1 / r
+            double rank = std::exp(hashToUnit(hash) * std::log((double)size + 1.0));
+            return (int)(std::min((std::ptrdiff_t)rank, size) / scale);
+        }
+        case DIST_GAUSSIAN:
+        {
+            //Box-Muller transform on two uniforms from the one hash
+            double u1 = ((hash >> 32) + 1.0) / 4294967297.0;
+            double u2 = (hash & 0xFFFFFFFFULL) / 4294967296.0;
+            double normal = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+            double value = 1073741824.0 + normal * 67108864.0;
+            return (int)std::min(2147483647.0, std::max(0.0, value));
+        }
+        case DIST_MEDIAN3_KILLER:
+            return (int)(medianOfThreeKiller(i, size) / scale);
+        default:
+            return (int)(hash >> 33);
+    }
+}
+
+//Function to fill array[0..size - 1] with the given distribution in parallel
+inline void generateDistribution(int array[], std::ptrdiff_t size, InputDistribution distribution, unsigned long long seed)
+{
+    #pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t i = 0; i < size; i++)
+    {
+        array[i] = distributionValue(distribution, i, size, seed);
+    }
+
+    if (distribution != DIST_NEARLY_SORTED)
+    {
+        return;
+    }
+
+    //Each block gets 1% of its elements swapped with other elements of the same block
+    std::ptrdiff_t blocks = (size + NEARLY_SORTED_BLOCK - 1) / NEARLY_SORTED_BLOCK;
+    #pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t block = 0; block < blocks; block++)
+    {
+        std::ptrdiff_t start = block * NEARLY_SORTED_BLOCK;
+        int length = (int)std::min<std::ptrdiff_t>(NEARLY_SORTED_BLOCK, size - start);
+        unsigned long long blockSeed = distributionHash(seed, -1 - block);
+        for (int swap = 0; swap < length / 100; swap++)
+        {
+            std::ptrdiff_t a = start + (std::ptrdiff_t)(distributionHash(blockSeed, 2 * swap) % length);
+            std::ptrdiff_t b = start + (std::ptrdiff_t)(distributionHash(blockSeed, 2 * swap + 1) % length);
+            std::swap(array[a], array[b]);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,210 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <time.h>
+#include <string>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <omp.h>
+#include "ExternalSort.h"
+
+using namespace std;
+
+//Function to format numbers with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    //Insert commas from right to left
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Function to write elements random ints to a binary file, returns their sum for verification
+bool generateInputFile(const string &path, long long elements, long long &sum)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == NULL)
+    {
+        cout << "Error: Could not create input file " << path << endl;
+        return false;
+    }
+
+    vector<int> block(EXTERNAL_MIN_BUFFER);
+    sum = 0;
+    for (long long written = 0; written < elements; )
+    {
+        int count = (int)min((long long)block.size(), elements - written);
+        for (int i = 0; i < count; i++)
+        {
+            block[i] = rand();
+            sum += block[i];
+        }
+        fwrite(block.data(), sizeof(int), count, file);
+        written += count;
+    }
+    return fclose(file) == 0;
+}
+
+//Function to verify a binary file is sorted and holds the expected number of elements with the expected sum (not timed)
+bool verifySortedFile(const string &path, long long elements, long long sum)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    vector<int> block(EXTERNAL_MIN_BUFFER);
+    long long count = 0;
+    long long total = 0;
+    bool sorted = true;
+    int previous = INT32_MIN;
+    int read;
+    while ((read = readBlock(file, block.data(), (int)block.size())) > 0)
+    {
+        for (int i = 0; i < read; i++)
+        {
+            if (block[i] < previous)
+            {
+                sorted = false;
+            }
+            previous = block[i];
+            total += block[i];
+        }
+        count += read;
+    }
+    fclose(file);
+
+    return sorted && count == elements && total == sum;
+}
+
+//Function to print one external sort's statistics
+void printStats(const externalSortStats &stats)
+{
+    cout << "  Runs: " << stats.runs << ", Passes: " << stats.passes << ", Time: " << fixed << setprecision(2)
+         << stats.seconds << " s, Throughput: " << setprecision(1) << stats.megabytesPerSecond << " MB/s" << endl;
+}
+
+//Main function that calls other functions
+//With no arguments the benchmark sorts generated files several times larger than the memory budget. With arguments it
+//sorts an existing file: ./ExternalSort <input> <output> [memory MB] [fan-in] [temp directory]
+int main(int argc, char* argv[])
+{
+    if (argc >= 3)
+    {
+        long long memoryElements = (argc >= 4 ? atoll(argv[3]) : 1024) * 1048576 / sizeof(int);
+        int fanIn = (argc >= 5) ? atoi(argv[4]) : 64;
+        string tempDirectory = (argc >= 6) ? argv[5] : ".";
+
+        cout << "Sorting " << argv[1] << " into " << argv[2] << endl;
+        externalSortStats stats = externalSort(argv[1], argv[2], tempDirectory, memoryElements, fanIn);
+        if (!stats.succeeded)
+        {
+            return 1;
+        }
+        cout << "  Elements: " << formatWithCommas(stats.elements) << endl;
+        printStats(stats);
+        return 0;
+    }
+
+    srand(time(0));
+
+    string filename = "ExternalSortResults.txt";
+    ofstream outfile(filename);
+    if (!outfile.is_open())
+    {
+        cout << "Error: Could not create output file " << filename << endl;
+        return 1;
+    }
+
+    outfile << "---------------------------------------------" << endl;
+    outfile << "External Sort Results" << endl;
+    outfile << "Threads: " << omp_get_max_threads() << endl;
+    outfile << "---------------------------------------------" << endl;
+    outfile << endl;
+
+    cout << "Starting External Sort Benchmark" << endl;
+    cout << "Threads: " << omp_get_max_threads() << endl;
+    cout << endl;
+
+    //Input sizes in ints (100 MB and 400 MB) against a 16 MB memory budget
+    long long testSizes[] = {25000000, 100000000};
+    int numSizes = sizeof(testSizes) / sizeof(testSizes[0]);
+    long long memoryElements = 4194304;
+
+    //A fan-in of 64 merges every run in one pass, a fan-in of 4 needs several
+    int fanIns[] = {64, 4};
+    int numFanIns = sizeof(fanIns) / sizeof(fanIns[0]);
+
+    string inputPath = "external_input.bin";
+    string outputPath = "external_output.bin";
+
+    outfile << "| Input Size (MB) | Memory (MB) | Fan-in | Runs | Passes | Time (s) | Throughput (MB/s) |" << endl;
+    outfile << "|-----------------|-------------|--------|------|--------|----------|-------------------|" << endl;
+
+    for (int sizeIndex = 0; sizeIndex < numSizes; sizeIndex++)
+    {
+        long long size = testSizes[sizeIndex];
+        long long megabytes = size * sizeof(int) / 1048576;
+        cout << "Testing input size: " << formatWithCommas(size) << " ints (" << megabytes << " MB)" << endl;
+
+        long long sum;
+        if (!generateInputFile(inputPath, size, sum))
+        {
+            return 1;
+        }
+
+        for (int fanInIndex = 0; fanInIndex < numFanIns; fanInIndex++)
+        {
+            int fanIn = fanIns[fanInIndex];
+            cout << "Fan-in: " << fanIn << endl;
+
+            //Disk timings vary more than in-memory ones, so each configuration is averaged over 3 runs
+            double totalSeconds = 0;
+            externalSortStats stats;
+            for (int run = 0; run < 3; run++)
+            {
+                stats = externalSort(inputPath, outputPath, ".", memoryElements, fanIn);
+                if (!stats.succeeded)
+                {
+                    return 1;
+                }
+                totalSeconds += stats.seconds;
+                if (!verifySortedFile(outputPath, size, sum))
+                {
+                    cout << "Output file was not a sorted copy of the input" << endl;
+                }
+            }
+            stats.seconds = totalSeconds / 3;
+            stats.megabytesPerSecond = (size * sizeof(int) / 1048576.0) / stats.seconds;
+            printStats(stats);
+
+            outfile << "| " << megabytes << " | " << memoryElements * sizeof(int) / 1048576 << " | " << fanIn << " | "
+                    << stats.runs << " | " << stats.passes << " | " << fixed << setprecision(2) << stats.seconds
+                    << " | " << setprecision(1) << stats.megabytesPerSecond << " |" << endl;
+        }
+
+        remove(inputPath.c_str());
+        remove(outputPath.c_str());
+    }
+
+    outfile << endl;
+    outfile.close();
+    cout << "\nResults written to: " << filename << endl;
+
+    return 0;
+}
@@ -0,0 +1,412 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include "SampleSort.h"
+#include "MergeSort.h"
+
+//External merge sort for files of 32-bit ints that don't fit in memory.
+//Files (input, runs and output) are raw native-endian 32-bit ints with no header, so a file's element count is its
+//size / 4. The sort works in passes over the data:
+//1. Run generation: the input is read a memory load at a time, sorted with the parallel samplesort and written out as
+//   a sorted run. Two load buffers alternate so one run is written in the background while the next is read and sorted
+//2. Merge passes: up to fanIn runs at a time are merged with a loser tree into a longer run, until one run is left,
+//   which is written to the output file. Every run reader and the writer are double-buffered: the merge works on one
+//   buffer while the other is read or written by a background task, so disk I/O overlaps the comparisons
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Smallest I/O buffer used by the run readers and writers (256 KB of ints)
+const int EXTERNAL_MIN_BUFFER = 65536;
+
+//Structure to hold what an external sort did
+struct externalSortStats
+{
+    bool succeeded;
+    long long elements;             //Elements sorted
+    int runs;                       //Sorted runs written by run generation
+    int passes;                     //Passes over the data (run generation plus merge passes)
+    double seconds;                 //Wall time of the whole sort
+    double megabytesPerSecond;      //Input size divided by wall time
+};
+
+//BUFFERED I/O SECTION ----------------------------------------------------------------------
+
+//Structure to hold a double-buffered reader over a run file
+//The merge consumes buffers[active] while the next block is read into the other buffer in the background.
+struct runReader
+{
+    FILE *file;
+    std::vector<int> buffers[2];
+    int active;
+    int position;
+    int count;
+    std::future<int> pending;
+};
+
+//Function to read up to capacity ints from file into buffer, returns how many were read
+inline int readBlock(FILE *file, int *buffer, int capacity)
+{
+    return (int)fread(buffer, sizeof(int), capacity, file);
+}
+
+//Function to start reading the next block into the inactive buffer in the background
+inline void prefetchRunBlock(runReader &reader)
+{
+    int *buffer = reader.buffers[1 - reader.active].data();
+    int capacity = (int)reader.buffers[1 - reader.active].size();
+    FILE *file = reader.file;
+    reader.pending = std::async(std::launch::async, readBlock, file, buffer, capacity);
+}
+
+//Function to open a run file for reading, returns false if it can't be opened
+//The first block is read straight away and the second is started in the background.
+inline bool openRunReader(runReader &reader, const std::string &path, int bufferElements)
+{
+    reader.file = fopen(path.c_str(), "rb");
+    if (reader.file == NULL)
+    {
+        std::cout << "Error: Could not open run file " << path << std::endl;
+        return false;
+    }
+    reader.buffers[0].resize(bufferElements);
+    reader.buffers[1].resize(bufferElements);
+    reader.active = 0;
+    reader.position = 0;
+    reader.count = readBlock(reader.file, reader.buffers[0].data(), bufferElements);
+    if (reader.count == bufferElements)
+    {
+        prefetchRunBlock(reader);
+    }
+    return true;
+}
+
+//Function to return true when the reader has no elements left
+inline bool runReaderDone(const runReader &reader)
+{
+    return reader.position == reader.count;
+}
+
+//Function to return the reader's current element
+inline int runReaderValue(const runReader &reader)
+{
+    return reader.buffers[reader.active][reader.position];
+}
+
+//Function to move the reader to its next element, switching to the prefetched block at the end of a buffer
+inline void runReaderAdvance(runReader &reader)
+{
+    reader.position++;
+    if (reader.position < reader.count || !reader.pending.valid())
+    {
+        return;
+    }
+
+    reader.count = reader.pending.get();
+    reader.active = 1 - reader.active;
+    reader.position = 0;
+    if (reader.count == (int)reader.buffers[reader.active].size())
+    {
+        prefetchRunBlock(reader);
+    }
+}
+
+//Function to close a run reader
+inline void closeRunReader(runReader &reader)
+{
+    if (reader.pending.valid())
+    {
+        reader.pending.wait();
+    }
+    fclose(reader.file);
+}
+
+//Structure to hold a double-buffered writer
+//Elements are collected in buffers[active], and a full buffer is written in the background while the other fills up.
+struct runWriter
+{
+    FILE *file;
+    std::vector<int> buffers[2];
+    int active;
+    int count;
+    bool failed;
+    std::future<bool> pending;
+};
+
+//Function to write count ints from buffer to file, returns false on a short write
+inline bool writeBlock(FILE *file, const int *buffer, int count)
+{
+    return (int)fwrite(buffer, sizeof(int), count, file) == count;
+}
+
+//Function to open a file for writing, returns false if it can't be created
+inline bool openRunWriter(runWriter &writer, const std::string &path, int bufferElements)
+{
+    writer.file = fopen(path.c_str(), "wb");
+    if (writer.file == NULL)
+    {
+        std::cout << "Error: Could not create file " << path << std::endl;
+        return false;
+    }
+    writer.buffers[0].resize(bufferElements);
+    writer.buffers[1].resize(bufferElements);
+    writer.active = 0;
+    writer.count = 0;
+    writer.failed = false;
+    return true;
+}
+
+//Function to hand the active buffer to a background write and switch to the other buffer
+inline void flushRunWriter(runWriter &writer)
+{
+    if (writer.pending.valid() && !writer.pending.get())
+    {
+        writer.failed = true;
+    }
+    writer.pending = std::async(std::launch::async, writeBlock, writer.file, (const int*)writer.buffers[writer.active].data(), writer.count);
+    writer.active = 1 - writer.active;
+    writer.count = 0;
+}
+
+//Function to append one element
+inline void runWriterPut(runWriter &writer, int value)
+{
+    writer.buffers[writer.active][writer.count++] = value;
+    if (writer.count == (int)writer.buffers[writer.active].size())
+    {
+        flushRunWriter(writer);
+    }
+}
+
+//Function to finish all writes and close the file, returns false if any write failed
+inline bool closeRunWriter(runWriter &writer)
+{
+    if (writer.count > 0)
+    {
+        flushRunWriter(writer);
+    }
+    if (writer.pending.valid() && !writer.pending.get())
+    {
+        writer.failed = true;
+    }
+    if (fclose(writer.file) != 0)
+    {
+        writer.failed = true;
+    }
+    return !writer.failed;
+}
+
+//RUN GENERATION SECTION --------------------------------------------------------------------
+
+//Function to return the path of run number index written by the given pass
+inline std::string runPath(const std::string &tempDirectory, int pass, int index)
+{
+    return tempDirectory + "/run_" + std::to_string(pass) + "_" + std::to_string(index) + ".bin";
+}
+
+//Function to split the input into sorted runs of up to loadElements ints, returns the run paths
+//Each load is sorted with the parallel samplesort and written in the background while the next load is read.
+inline bool generateRuns(const std::string &inputPath, const std::string &tempDirectory, int loadElements, std::vector<std::string> &runs, long long &elements)
+{
+    FILE *input = fopen(inputPath.c_str(), "rb");
+    if (input == NULL)
+    {
+        std::cout << "Error: Could not open input file " << inputPath << std::endl;
+        return false;
+    }
+
+    std::vector<int> loads[2] = {std::vector<int>(loadElements), std::vector<int>(loadElements)};
+    std::future<bool> pending;
+    bool succeeded = true;
+    elements = 0;
+
+    for (int load = 0; succeeded; load = 1 - load)
+    {
+        int count = readBlock(input, loads[load].data(), loadElements);
+        if (count == 0)
+        {
+            break;
+        }
+        elements += count;
+        sampleSort(loads[load].data(), count);
+
+        //The previous run has to be on disk before its buffer is reused for the next load
+        if (pending.valid() && !pending.get())
+        {
+            succeeded = false;
+        }
+
+        std::string path = runPath(tempDirectory, 0, (int)runs.size());
+        runs.push_back(path);
+        const int *data = loads[load].data();
+        pending = std::async(std::launch::async, [path, data, count]()
+        {
+            FILE *file = fopen(path.c_str(), "wb");
+            if (file == NULL)
+            {
+                return false;
+            }
+            bool written = writeBlock(file, data, count);
+            return (fclose(file) == 0) && written;
+        });
+
+        if (count < loadElements)
+        {
+            break;
+        }
+    }
+
+    if (pending.valid() && !pending.get())
+    {
+        succeeded = false;
+    }
+    fclose(input);
+
+    if (!succeeded)
+    {
+        std::cout << "Error: Could not write runs to " << tempDirectory << std::endl;
+    }
+    return succeeded;
+}
+
+//MERGE SECTION -----------------------------------------------------------------------------
+
+//Function to merge the given run files into outputPath with a loser tree, returns false on an I/O error
+inline bool mergeRuns(const std::vector<std::string> &inputs, const std::string &outputPath, int bufferElements)
+{
+    int k = (int)inputs.size();
+    std::vector<runReader> readers(k);
+    for (int r = 0; r < k; r++)
+    {
+        if (!openRunReader(readers[r], inputs[r], bufferElements))
+        {
+            for (int open = 0; open < r; open++)
+            {
+                closeRunReader(readers[open]);
+            }
+            return false;
+        }
+    }
+
+    runWriter writer;
+    if (!openRunWriter(writer, outputPath, bufferElements))
+    {
+        for (int r = 0; r < k; r++)
+        {
+            closeRunReader(readers[r]);
+        }
+        return false;
+    }
+
+    auto beats = [&](int x, int y)
+    {
+        if (runReaderDone(readers[x])) return false;
+        if (runReaderDone(readers[y])) return true;
+        int valueX = runReaderValue(readers[x]);
+        int valueY = runReaderValue(readers[y]);
+        return valueX < valueY || (valueX == valueY && x < y);
+    };
+
+    loserTree tree;
+    initLoserTree(tree, k, beats);
+    while (!runReaderDone(readers[tree.nodes[0]]))
+    {
+        runReader &winner = readers[tree.nodes[0]];
+        runWriterPut(writer, runReaderValue(winner));
+        runReaderAdvance(winner);
+        replayLoserTree(tree, beats);
+    }
+
+    for (int r = 0; r < k; r++)
+    {
+        closeRunReader(readers[r]);
+    }
+    bool written = closeRunWriter(writer);
+    if (!written)
+    {
+        std::cout << "Error: Could not write " << outputPath << std::endl;
+    }
+    return written;
+}
+
+//Function to externally sort the ints in inputPath into outputPath
+//memoryElements is the memory budget in ints. Run generation splits it between its two load buffers, and a merge
+//splits it between the double buffers of up to fanIn readers and the writer. Runs go to tempDirectory and are
+//deleted once merged.
+inline externalSortStats externalSort(const std::string &inputPath, const std::string &outputPath, const std::string &tempDirectory, long long memoryElements, int fanIn)
+{
+    externalSortStats stats = {false, 0, 0, 0, 0.0, 0.0};
+    auto start = std::chrono::high_resolution_clock::now();
+
+    fanIn = std::max(2, fanIn);
+    int loadElements = (int)std::min((long long)INT32_MAX / 2, std::max((long long)EXTERNAL_MIN_BUFFER, memoryElements / 2));
+    int bufferElements = (int)std::max((long long)EXTERNAL_MIN_BUFFER, memoryElements / (2 * (fanIn + 1)));
+
+    std::vector<std::string> runs;
+    if (!generateRuns(inputPath, tempDirectory, loadElements, runs, stats.elements))
+    {
+        return stats;
+    }
+    stats.runs = (int)runs.size();
+    stats.passes = 1;
+
+    if (runs.empty())
+    {
+        //Empty input, so the output is an empty file
+        FILE *output = fopen(outputPath.c_str(), "wb");
+        if (output == NULL)
+        {
+            std::cout << "Error: Could not create file " << outputPath << std::endl;
+            return stats;
+        }
+        fclose(output);
+    }
+
+    //Each merge pass merges groups of fanIn runs, the pass that leaves a single run writes straight to the output
+    for (int pass = 1; !runs.empty(); pass++)
+    {
+        bool lastPass = (int)runs.size() <= fanIn;
+        if (runs.size() == 1 && std::rename(runs[0].c_str(), outputPath.c_str()) == 0)
+        {
+            break;
+        }
+
+        std::vector<std::string> merged;
+        for (size_t first = 0; first < runs.size(); first += fanIn)
+        {
+            size_t last = std::min(runs.size(), first + fanIn);
+            std::vector<std::string> group(runs.begin() + first, runs.begin() + last);
+            std::string path = lastPass ? outputPath : runPath(tempDirectory, pass, (int)merged.size());
+            if (!mergeRuns(group, path, bufferElements))
+            {
+                return stats;
+            }
+            for (size_t r = 0; r < group.size(); r++)
+            {
+                std::remove(group[r].c_str());
+            }
+            merged.push_back(path);
+        }
+        stats.passes++;
+
+        if (lastPass)
+        {
+            break;
+        }
+        runs = merged;
+    }
+
+    auto stop = std::chrono::high_resolution_clock::now();
+    stats.seconds = std::chrono::duration<double>(stop - start).count();
+    stats.megabytesPerSecond = (stats.seconds > 0) ? (stats.elements * sizeof(int) / 1048576.0) / stats.seconds : 0.0;
+    stats.succeeded = true;
+    return stats;
+}
+
+#endif
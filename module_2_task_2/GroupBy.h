@@ -0,0 +1,197 @@
+#ifndef GROUP_BY_H
+#define GROUP_BY_H
+
+#include <omp.h>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+//Operators that turn the output of the sorts into deduplicated values, distinct counts and per-key aggregates.
+//Once the input is sorted every group of equal keys is one contiguous run, so each operator is a linear scan:
+//1. Every thread takes an equal chunk and counts the runs that start in it (an element that differs from the one
+//   before it starts a run)
+//2. A prefix sum over the per-thread counts gives each thread the output position of its first run
+//3. Every thread writes the runs that start in its chunk, following the last one past the end of its chunk if needed
+//A run belongs to the thread whose chunk it starts in, so no two threads ever write the same output.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Inputs at or below this size are scanned by one thread
+const int GROUP_BY_PARALLEL_CUTOFF = 65536;
+
+//Sum type for an aggregated value: long long for integer values (so int sums don't overflow), double otherwise
+template <typename Value>
+using aggregateSum = typename std::conditional<std::is_floating_point<Value>::value, double, long long>::type;
+
+//Structure to hold the aggregates of one key
+template <typename Key, typename Value>
+struct keyAggregate
+{
+    Key key;
+    long long count;
+    aggregateSum<Value> sum;
+    Value min;
+    Value max;
+};
+
+//RUN COUNTING SECTION ----------------------------------------------------------------------
+
+//Function to return the number of threads to scan size elements with
+inline int groupByThreads(std::ptrdiff_t size)
+{
+    return (size > GROUP_BY_PARALLEL_CUTOFF) ? omp_get_max_threads() : 1;
+}
+
+//Function to count the runs of equal keys that start in array[start..end - 1]
+template <typename T, typename KeyOf>
+inline std::ptrdiff_t countRunStarts(const T array[], std::ptrdiff_t start, std::ptrdiff_t end, KeyOf key)
+{
+    std::ptrdiff_t runs = 0;
+    for (std::ptrdiff_t i = start; i < end; i++)
+    {
+        runs += (i == 0 || !(key(array[i]) == key(array[i - 1])));
+    }
+    return runs;
+}
+
+//Function to find the first run start at or after position start, size if there is none
+template <typename T, typename KeyOf>
+inline std::ptrdiff_t nextRunStart(const T array[], std::ptrdiff_t start, std::ptrdiff_t size, KeyOf key)
+{
+    while (start > 0 && start < size && key(array[start]) == key(array[start - 1]))
+    {
+        start++;
+    }
+    return start;
+}
+
+//Function to compute, for equal chunks of array[0..size - 1] per thread of the calling team, where each thread's
+//runs go in the output (runOffsets[t], with the total in runOffsets[team size])
+//Called by every thread of the team. The chunks are cut for the team actually running, which can be smaller than the
+//one asked for (inside another parallel region, or with dynamic threads), and every thread returns with the offsets
+//complete.
+template <typename T, typename KeyOf>
+inline void prefixRunCounts(const T array[], std::ptrdiff_t size, std::vector<std::ptrdiff_t> &runOffsets, KeyOf key)
+{
+    int team = omp_get_num_threads();
+    int t = omp_get_thread_num();
+    #pragma omp single
+    runOffsets.assign(team + 1, 0);
+
+    runOffsets[t + 1] = countRunStarts(array, size * t / team, size * (t + 1) / team, key);
+    #pragma omp barrier
+
+    #pragma omp single
+    for (int u = 0; u < team; u++)
+    {
+        runOffsets[u + 1] += runOffsets[u];
+    }
+}
+
+//OPERATOR SECTION --------------------------------------------------------------------------
+
+//Function to return the number of distinct keys in the sorted array[0..size - 1]
+template <typename T, typename KeyOf>
+inline std::ptrdiff_t parallelCountDistinct(const T array[], std::ptrdiff_t size, KeyOf key)
+{
+    std::ptrdiff_t distinct = 0;
+    #pragma omp parallel for reduction(+:distinct) schedule(static) if (size > GROUP_BY_PARALLEL_CUTOFF)
+    for (std::ptrdiff_t i = 0; i < size; i++)
+    {
+        distinct += (i == 0 || !(key(array[i]) == key(array[i - 1])));
+    }
+    return distinct;
+}
+
+//Function to return the number of distinct values in the sorted array[0..size - 1]
+template <typename T>
+inline std::ptrdiff_t parallelCountDistinct(const T array[], std::ptrdiff_t size)
+{
+    return parallelCountDistinct(array, size, [](const T &value) -> const T& { return value; });
+}
+
+//Function to copy the first element of every run of equal values in the sorted input[0..size - 1] to output, in
+//order, returns how many were written (output must hold that many and must not overlap input)
+template <typename T>
+inline std::ptrdiff_t parallelUnique(const T input[], std::ptrdiff_t size, T output[])
+{
+    auto identity = [](const T &value) -> const T& { return value; };
+    std::vector<std::ptrdiff_t> runOffsets;
+
+    #pragma omp parallel num_threads(groupByThreads(size))
+    {
+        prefixRunCounts(input, size, runOffsets, identity);
+
+        int team = omp_get_num_threads();
+        int t = omp_get_thread_num();
+        std::ptrdiff_t end = size * (t + 1) / team;
+        std::ptrdiff_t position = runOffsets[t];
+        for (std::ptrdiff_t i = size * t / team; i < end; i++)
+        {
+            if (i == 0 || !(input[i] == input[i - 1]))
+            {
+                output[position++] = input[i];
+            }
+        }
+    }
+    return runOffsets.back();
+}
+
+//Function to remove the repeated values from a sorted vector
+template <typename T>
+inline void parallelUnique(std::vector<T> &values)
+{
+    std::vector<T> unique(values.size());
+    unique.resize(parallelUnique(values.data(), (std::ptrdiff_t)values.size(), unique.data()));
+    values.swap(unique);
+}
+
+//Function to aggregate the elements of array[0..size - 1], sorted by key, into one count, sum, min and max of the
+//extracted value per distinct key, in key order
+//A key whose run spans several chunks is aggregated entirely by the thread its run starts with, so a single key
+//holding most of the array is aggregated by one thread.
+template <typename T, typename KeyOf, typename ValueOf>
+inline auto parallelGroupByKey(const T array[], std::ptrdiff_t size, KeyOf key, ValueOf value)
+{
+    typedef typename std::decay<decltype(key(array[0]))>::type Key;
+    typedef typename std::decay<decltype(value(array[0]))>::type Value;
+
+    std::vector<std::ptrdiff_t> runOffsets;
+    std::vector<keyAggregate<Key, Value>> groups;
+
+    #pragma omp parallel num_threads(groupByThreads(size))
+    {
+        prefixRunCounts(array, size, runOffsets, key);
+        int team = omp_get_num_threads();
+        #pragma omp single
+        groups.resize(runOffsets[team]);
+
+        int t = omp_get_thread_num();
+        std::ptrdiff_t end = size * (t + 1) / team;
+        std::ptrdiff_t position = runOffsets[t];
+        std::ptrdiff_t i = nextRunStart(array, size * t / team, size, key);
+        while (i < end)
+        {
+            keyAggregate<Key, Value> &group = groups[position++];
+            Value first = value(array[i]);
+            group.key = key(array[i]);
+            group.count = 1;
+            group.sum = first;
+            group.min = first;
+            group.max = first;
+            for (i++; i < size && key(array[i]) == group.key; i++)
+            {
+                Value current = value(array[i]);
+                group.count++;
+                group.sum += current;
+                group.min = std::min(group.min, current);
+                group.max = std::max(group.max, current);
+            }
+        }
+    }
+    return groups;
+}
+
+#endif
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <cstdlib>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <omp.h>
+#include "IncrementalSort.h"
+
+using namespace std::chrono;
+using namespace std;
+
+//Function to format numbers with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    //Insert commas from right to left
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Function to initialize array with random values
+void initializeArray(int array[], ptrdiff_t size)
+{
+    for (ptrdiff_t i = 0; i < size; i++)
+    {
+        array[i] = rand();
+    }
+}
+
+//Main function that calls other functions
+//A sorted array of 10,000,000 elements receives 20 unsorted batches, which are added three ways: appending the batch
+//and sorting the whole array again with the samplesort, merging it in with mergeBatch, and inserting it into an LSM
+//set of sorted levels (the time for the LSM is the insert itself, its compaction runs in the background).
+//All three must end up holding the same sorted elements.
+int main()
+{
+    string filename = "IncrementalBenchmarkResults.txt";
+    ofstream outfile(filename);
+    if (!outfile.is_open())
+    {
+        cout << "Error: Could not create output file " << filename << endl;
+        return 1;
+    }
+
+    const ptrdiff_t baseSize = 10000000;
+    const int numBatches = 20;
+
+    outfile << "---------------------------------------------" << endl;
+    outfile << "Incremental Sort Benchmark Results" << endl;
+    outfile << "Threads: " << omp_get_max_threads() << endl;
+    outfile << "Sorted array: " << formatWithCommas(baseSize) << " elements, " << numBatches << " batches" << endl;
+    outfile << "---------------------------------------------" << endl;
+    outfile << endl;
+
+    cout << "Starting Incremental Sort Benchmark" << endl;
+    cout << "Threads: " << omp_get_max_threads() << endl;
+    cout << endl;
+
+    int batchSizes[] = {1000, 100000};
+    int numSizes = sizeof(batchSizes) / sizeof(batchSizes[0]);
+
+    outfile << "| Batch Size | Full Re-sort (us/batch) | mergeBatch (us/batch) | LSM Insert (us/batch) | mergeBatch Speedup |" << endl;
+    outfile << "|------------|-------------------------|-----------------------|-----------------------|--------------------|" << endl;
+
+    srand(time(0));
+    vector<int> base(baseSize);
+    initializeArray(base.data(), baseSize);
+    sampleSort(base.data(), baseSize);
+
+    for (int sizeIndex = 0; sizeIndex < numSizes; sizeIndex++)
+    {
+        int batchSize = batchSizes[sizeIndex];
+        cout << "Testing batch size: " << formatWithCommas(batchSize) << endl;
+
+        vector<int> resorted(base);
+        vector<int> merged(base);
+        lsmSortedSet set;
+        lsmInsert(set, base.data(), baseSize);
+        lsmWait(set);
+
+        long long resortTime = 0, mergeTime = 0, lsmTime = 0;
+        vector<int> batch(batchSize);
+        vector<int> copy(batchSize);
+        for (int b = 0; b < numBatches; b++)
+        {
+            initializeArray(batch.data(), batchSize);
+
+            auto start = high_resolution_clock::now();
+            resorted.insert(resorted.end(), batch.begin(), batch.end());
+            sampleSort(resorted.data(), (ptrdiff_t)resorted.size());
+            auto stop = high_resolution_clock::now();
+            resortTime += duration_cast<microseconds>(stop - start).count();
+
+            copy = batch;
+            start = high_resolution_clock::now();
+            mergeBatch(merged, copy.data(), batchSize);
+            stop = high_resolution_clock::now();
+            mergeTime += duration_cast<microseconds>(stop - start).count();
+
+            copy = batch;
+            start = high_resolution_clock::now();
+            lsmInsert(set, copy.data(), batchSize);
+            stop = high_resolution_clock::now();
+            lsmTime += duration_cast<microseconds>(stop - start).count();
+        }
+
+        lsmWait(set);
+        vector<int> flattened;
+        lsmFlatten(set, flattened);
+        if (merged != resorted || flattened != resorted)
+        {
+            outfile << "Batch size " << formatWithCommas(batchSize) << " did not produce the same sorted array" << endl;
+            cout << "  mergeBatch or the LSM set did not produce the same sorted array as the re-sort" << endl;
+        }
+
+        long long resortAverage = resortTime / numBatches;
+        long long mergeAverage = mergeTime / numBatches;
+        long long lsmAverage = lsmTime / numBatches;
+        double speedup = (mergeAverage > 0) ? (double)resortAverage / mergeAverage : 0.0;
+        outfile << "| " << formatWithCommas(batchSize) << " | " << formatWithCommas(resortAverage) << " | " << formatWithCommas(mergeAverage)
+                << " | " << formatWithCommas(lsmAverage) << " | " << fixed << setprecision(1) << speedup << "x |" << endl;
+        cout << "  Re-sort: " << formatWithCommas(resortAverage) << " us, mergeBatch: " << formatWithCommas(mergeAverage)
+             << " us, LSM insert: " << formatWithCommas(lsmAverage) << " us (" << set.levels.size() << " levels)" << endl;
+    }
+
+    outfile << endl;
+    outfile.close();
+    cout << "\nResults written to: " << filename << endl;
+
+    return 0;
+}
@@ -0,0 +1,267 @@
+#ifndef INCREMENTAL_SORT_H
+#define INCREMENTAL_SORT_H
+
+#include <omp.h>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <cstddef>
+#include <algorithm>
+#include "SampleSort.h"
+#include "MergeSort.h"
+
+//Keeping a large sorted array up to date as small unsorted batches arrive, without sorting the whole array again.
+//1. mergeBatch sorts the batch with the samplesort and merges it into the sorted array in place. Every thread takes
+//   an equal merge path slice of the output and merges it backwards, so the only extra memory is the saved heads of
+//   the threads' array parts, at most (threads - 1) batches and never the whole array
+//2. lsmSortedSet keeps the data as a list of sorted levels instead (like an LSM tree). Inserting a batch only sorts
+//   it and appends it as a new level, and a background task merges the newer levels together whenever together they
+//   are at least as big as an older level, so there are O(log n) levels and each element is merged O(log n) times.
+//   Queries search every level
+
+//IN-PLACE MERGE SECTION --------------------------------------------------------------------
+
+//Function to merge part[0..partSize - 1] and batch[0..batchSize - 1] backwards into output[0..partSize + batchSize - 1]
+//output may overlap part as long as it doesn't start before it: writing from the back never overtakes the part
+//elements still to be read. The first headSize elements of part are read from head instead, for when they are
+//overwritten by someone else. Ties go to part, so equal elements already in the array stay in front of new ones.
+inline void mergeBackward(const int part[], std::ptrdiff_t partSize, const int head[], std::ptrdiff_t headSize, const int batch[], std::ptrdiff_t batchSize, int output[])
+{
+    std::ptrdiff_t i = partSize - 1;
+    std::ptrdiff_t j = batchSize - 1;
+    for (std::ptrdiff_t k = partSize + batchSize - 1; k >= 0; k--)
+    {
+        //Once the batch is used up a part that is merged onto itself is already in place
+        if (j < 0 && output == part && headSize == 0)
+        {
+            return;
+        }
+        if (j < 0 || (i >= 0 && batch[j] < ((i < headSize) ? head[i] : part[i])))
+        {
+            output[k] = (i < headSize) ? head[i] : part[i];
+            i--;
+        }
+        else
+        {
+            output[k] = batch[j--];
+        }
+    }
+}
+
+//Function to merge a sorted batch into the sorted vector in parallel, with extra memory of O(T * batchSize)
+//Thread t merges output slice [t * total / T, (t + 1) * total / T), found with merge path, backwards in place.
+//The slice starts at or after the first array element the thread reads, but the earlier threads write below it,
+//over the head of its array part. Each thread copies that head to a buffer before anyone writes. A head is no longer
+//than the number of batch elements before the thread's slice, so the heads add up to at most
+//min(size, (T - 1) * batchSize), which is reached when the batch keys sort before most of the array.
+inline void mergeSortedBatch(std::vector<int> &sorted, const int batch[], std::ptrdiff_t batchSize)
+{
+    std::ptrdiff_t size = (std::ptrdiff_t)sorted.size();
+    std::ptrdiff_t total = size + batchSize;
+    sorted.resize(total);
+    int *array = sorted.data();
+
+    //The slices are cut for the team actually running, which can be smaller than the one asked for
+    int threads = 1;
+    std::vector<std::ptrdiff_t> splitA;
+    std::vector<std::ptrdiff_t> headStart;
+    std::vector<int> heads;
+
+    #pragma omp parallel num_threads((total > MERGE_SORT_PARALLEL_CUTOFF) ? omp_get_max_threads() : 1)
+    {
+        #pragma omp single
+        {
+            threads = omp_get_num_threads();
+            splitA.resize(threads + 1);
+            headStart.resize(threads + 1);
+            for (int t = 0; t <= threads; t++)
+            {
+                std::ptrdiff_t diag = total * t / threads;
+                splitA[t] = mergePathSplit(array, size, batch, batchSize, diag, std::less<int>());
+            }
+
+            //Thread t's array part [splitA[t], splitA[t + 1]) is overwritten by earlier threads below its output start
+            headStart[0] = 0;
+            for (int t = 0; t < threads; t++)
+            {
+                std::ptrdiff_t outputStart = total * t / threads;
+                std::ptrdiff_t headEnd = std::min(splitA[t + 1], outputStart);
+                headStart[t + 1] = headStart[t] + std::max<std::ptrdiff_t>(0, headEnd - splitA[t]);
+            }
+            heads.resize(headStart[threads]);
+        }
+
+        int t = omp_get_thread_num();
+        std::ptrdiff_t outputStart = total * t / threads;
+        std::ptrdiff_t outputEnd = total * (t + 1) / threads;
+        std::ptrdiff_t aStart = splitA[t];
+        std::ptrdiff_t aEnd = splitA[t + 1];
+        std::ptrdiff_t bStart = outputStart - aStart;
+        std::ptrdiff_t bEnd = outputEnd - aEnd;
+        std::ptrdiff_t headLength = headStart[t + 1] - headStart[t];
+
+        std::copy(array + aStart, array + aStart + headLength, heads.data() + headStart[t]);
+        #pragma omp barrier
+
+        mergeBackward(array + aStart, aEnd - aStart, heads.data() + headStart[t], headLength, batch + bStart, bEnd - bStart, array + outputStart);
+    }
+}
+
+//Function to sort batch[0..batchSize - 1] (in place) and merge it into the sorted vector
+inline void mergeBatch(std::vector<int> &sorted, int batch[], std::ptrdiff_t batchSize)
+{
+    if (batchSize <= 0)
+    {
+        return;
+    }
+    sampleSort(batch, batchSize);
+    mergeSortedBatch(sorted, batch, batchSize);
+}
+
+//LSM LEVELS SECTION ------------------------------------------------------------------------
+
+//Structure to hold a sorted multiset as a list of sorted levels, oldest (and largest) first
+//Levels are never changed once made, so a snapshot of the list can be searched while compaction replaces levels.
+struct lsmSortedSet
+{
+    std::vector<std::shared_ptr<const std::vector<int>>> levels;
+    std::mutex lock;                    //Guards levels and compacting
+    bool compacting = false;            //True while the background compaction task runs
+    std::future<void> compaction;
+};
+
+//Function to find the first level that should be merged with every level after it, -1 if none
+//A level is merged once the levels after it hold at least as many elements, which keeps the levels growing
+//geometrically towards the oldest, like the digits of a binary counter. Called with the lock held.
+inline int lsmCompactionStart(const lsmSortedSet &set)
+{
+    std::ptrdiff_t newer = 0;
+    int start = -1;
+    for (int level = (int)set.levels.size() - 1; level >= 0; level--)
+    {
+        std::ptrdiff_t levelSize = (std::ptrdiff_t)set.levels[level]->size();
+        if (level < (int)set.levels.size() - 1 && levelSize <= newer)
+        {
+            start = level;
+        }
+        newer += levelSize;
+    }
+    return start;
+}
+
+//Function run by the background task: merge levels until no level needs merging
+//The levels to merge are copied out under the lock and merged without it, so inserts and queries carry on. Levels
+//inserted meanwhile are only appended, so the merged ones are still at the same positions when they are replaced.
+inline void lsmCompact(lsmSortedSet *set)
+{
+    while (true)
+    {
+        std::vector<std::shared_ptr<const std::vector<int>>> merging;
+        int start;
+        {
+            std::lock_guard<std::mutex> guard(set->lock);
+            start = lsmCompactionStart(*set);
+            if (start < 0)
+            {
+                set->compacting = false;
+                return;
+            }
+            merging.assign(set->levels.begin() + start, set->levels.end());
+        }
+
+        std::vector<mergeSequence<int>> sequences;
+        std::ptrdiff_t total = 0;
+        for (size_t level = 0; level < merging.size(); level++)
+        {
+            sequences.push_back({merging[level]->data(), (std::ptrdiff_t)merging[level]->size()});
+            total += (std::ptrdiff_t)merging[level]->size();
+        }
+        std::shared_ptr<std::vector<int>> merged = std::make_shared<std::vector<int>>(total);
+        parallelMultiwayMerge(sequences, merged->data());
+
+        std::lock_guard<std::mutex> guard(set->lock);
+        set->levels.erase(set->levels.begin() + start, set->levels.begin() + start + merging.size());
+        set->levels.insert(set->levels.begin() + start, merged);
+    }
+}
+
+//Function to sort batch[0..batchSize - 1] (in place), add it to the set as the newest level and start a background
+//compaction if the levels need merging and none is running
+inline void lsmInsert(lsmSortedSet &set, int batch[], std::ptrdiff_t batchSize)
+{
+    if (batchSize <= 0)
+    {
+        return;
+    }
+    sampleSort(batch, batchSize);
+    std::shared_ptr<const std::vector<int>> level = std::make_shared<const std::vector<int>>(batch, batch + batchSize);
+
+    std::lock_guard<std::mutex> guard(set.lock);
+    set.levels.push_back(level);
+    if (!set.compacting && lsmCompactionStart(set) >= 0)
+    {
+        set.compacting = true;
+        set.compaction = std::async(std::launch::async, lsmCompact, &set);
+    }
+}
+
+//Function to wait for the background compaction (if any) to finish
+inline void lsmWait(lsmSortedSet &set)
+{
+    if (set.compaction.valid())
+    {
+        set.compaction.wait();
+    }
+}
+
+//Function to return the current levels, which stay valid (and sorted) however the set changes afterwards
+inline std::vector<std::shared_ptr<const std::vector<int>>> lsmSnapshot(lsmSortedSet &set)
+{
+    std::lock_guard<std::mutex> guard(set.lock);
+    return set.levels;
+}
+
+//Function to return the number of elements in the set less than value
+inline std::ptrdiff_t lsmCountLess(lsmSortedSet &set, int value)
+{
+    std::ptrdiff_t count = 0;
+    for (const auto &level : lsmSnapshot(set))
+    {
+        count += std::lower_bound(level->begin(), level->end(), value) - level->begin();
+    }
+    return count;
+}
+
+//Function to check whether value is in the set
+inline bool lsmContains(lsmSortedSet &set, int value)
+{
+    for (const auto &level : lsmSnapshot(set))
+    {
+        if (std::binary_search(level->begin(), level->end(), value))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//Function to write every element of the set to output in sorted order
+inline void lsmFlatten(lsmSortedSet &set, std::vector<int> &output)
+{
+    std::vector<std::shared_ptr<const std::vector<int>>> levels = lsmSnapshot(set);
+    std::vector<mergeSequence<int>> sequences;
+    std::ptrdiff_t total = 0;
+    for (size_t level = 0; level < levels.size(); level++)
+    {
+        sequences.push_back({levels[level]->data(), (std::ptrdiff_t)levels[level]->size()});
+        total += (std::ptrdiff_t)levels[level]->size();
+    }
+    output.resize(total);
+    if (total > 0)
+    {
+        parallelMultiwayMerge(sequences, output.data());
+    }
+}
+
+#endif
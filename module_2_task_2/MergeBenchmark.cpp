@@ -0,0 +1,190 @@
+#include <iostream>
+#include <cstdlib>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+#include "MergeSort.h"
+
+using namespace std::chrono;
+using namespace std;
+
+//Function to format numbers with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    //Insert commas from right to left
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Function to fill sequences[0..k - 1] with sorted random values, total elements in all
+void initializeSortedSequences(vector<vector<int>> &sequences, int k, int total)
+{
+    sequences.assign(k, vector<int>());
+    for (int s = 0; s < k; s++)
+    {
+        int size = (int)((long long)total * (s + 1) / k - (long long)total * s / k);
+        sequences[s].resize(size);
+        for (int i = 0; i < size; i++)
+        {
+            sequences[s][i] = rand();
+        }
+        sort(sequences[s].begin(), sequences[s].end());
+    }
+}
+
+//Function to verify if array is sorted (not timed)
+bool verifySorted(const int array[], int size)
+{
+    for (int i = 0; i < size - 1; i++)
+    {
+        if (array[i] > array[i + 1])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//Function to write one result row to the file and console
+void reportRow(ofstream &outfile, const string &merge, int elements, int threads, long long totalTime)
+{
+    long long average = totalTime / 10;
+    long long throughput = (average > 0) ? (long long)elements / average : 0;
+
+    outfile << "| " << merge << " | " << formatWithCommas(elements) << " | " << threads
+            << " | " << formatWithCommas(average) << " | " << formatWithCommas(throughput) << " |" << endl;
+    cout << "  " << merge << ", " << threads << " threads: " << formatWithCommas(average) << " us ("
+         << formatWithCommas(throughput) << " M elements/s)" << endl;
+}
+
+//Main function that calls other functions
+int main()
+{
+    srand(time(0));
+
+    string filename = "MergeBenchmarkResults.txt";
+    ofstream outfile(filename);
+    if (!outfile.is_open())
+    {
+        cout << "Error: Could not create output file " << filename << endl;
+        return 1;
+    }
+
+    int hardwareThreads = omp_get_num_procs();
+
+    outfile << "---------------------------------------------" << endl;
+    outfile << "Parallel Merge Benchmark Results" << endl;
+    outfile << "Hardware threads: " << hardwareThreads << endl;
+    outfile << "---------------------------------------------" << endl;
+    outfile << endl;
+
+    cout << "Starting Parallel Merge Benchmark" << endl;
+    cout << "Hardware threads: " << hardwareThreads << endl;
+    cout << endl;
+
+    //Thread counts above the hardware threads are skipped
+    int threadCounts[] = {1, 2, 4, 8, 16};
+    int numThreadCounts = sizeof(threadCounts) / sizeof(threadCounts[0]);
+
+    int testSizes[] = {1000000, 10000000};
+    int numSizes = sizeof(testSizes) / sizeof(testSizes[0]);
+
+    int wayCounts[] = {4, 16, 64};
+    int numWayCounts = sizeof(wayCounts) / sizeof(wayCounts[0]);
+
+    outfile << "| Merge | Elements | Threads | Time (us) | Throughput (M elements/s) |" << endl;
+    outfile << "|-------|----------|---------|-----------|---------------------------|" << endl;
+
+    for (int sizeIndex = 0; sizeIndex < numSizes; sizeIndex++)
+    {
+        int size = testSizes[sizeIndex];
+        vector<int> output(size);
+
+        //Two-way merge of two sorted halves
+        cout << "Two-way merge, elements: " << formatWithCommas(size) << endl;
+        vector<vector<int>> halves;
+        initializeSortedSequences(halves, 2, size);
+
+        for (int threadIndex = 0; threadIndex < numThreadCounts; threadIndex++)
+        {
+            int threads = threadCounts[threadIndex];
+            if (threads > hardwareThreads && threads > 1) continue;
+            omp_set_num_threads(threads);
+
+            long long totalTime = 0;
+            for (int run = 0; run < 10; run++)
+            {
+                auto start = high_resolution_clock::now();
+                parallelMerge(halves[0].data(), (int)halves[0].size(), halves[1].data(), (int)halves[1].size(), output.data());
+                auto stop = high_resolution_clock::now();
+                totalTime += duration_cast<microseconds>(stop - start).count();
+            }
+            if (!verifySorted(output.data(), size))
+            {
+                cout << "Two-way merge did not produce a sorted array" << endl;
+            }
+            reportRow(outfile, "2-way", size, threads, totalTime);
+        }
+
+        //K-way merge of k sorted sequences
+        for (int wayIndex = 0; wayIndex < numWayCounts; wayIndex++)
+        {
+            int k = wayCounts[wayIndex];
+            cout << k << "-way merge, elements: " << formatWithCommas(size) << endl;
+
+            vector<vector<int>> sequences;
+            initializeSortedSequences(sequences, k, size);
+            vector<mergeSequence<int>> inputs(k);
+            for (int s = 0; s < k; s++)
+            {
+                inputs[s].data = sequences[s].data();
+                inputs[s].size = (int)sequences[s].size();
+            }
+
+            for (int threadIndex = 0; threadIndex < numThreadCounts; threadIndex++)
+            {
+                int threads = threadCounts[threadIndex];
+                if (threads > hardwareThreads && threads > 1) continue;
+                omp_set_num_threads(threads);
+
+                long long totalTime = 0;
+                for (int run = 0; run < 10; run++)
+                {
+                    auto start = high_resolution_clock::now();
+                    parallelMultiwayMerge(inputs, output.data());
+                    auto stop = high_resolution_clock::now();
+                    totalTime += duration_cast<microseconds>(stop - start).count();
+                }
+                if (!verifySorted(output.data(), size))
+                {
+                    cout << k << "-way merge did not produce a sorted array" << endl;
+                }
+                reportRow(outfile, to_string(k) + "-way", size, threads, totalTime);
+            }
+        }
+    }
+
+    outfile << endl;
+    outfile.close();
+    cout << "\nResults written to: " << filename << endl;
+
+    return 0;
+}
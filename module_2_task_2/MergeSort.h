@@ -0,0 +1,416 @@
+#ifndef MERGE_SORT_H
+#define MERGE_SORT_H
+
+#include <omp.h>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include "SortEngine.h"
+
+//Stable parallel merge sort and the parallel merge primitives it is built from.
+//Merges are split between threads with merge path: the output is cut into equal slices and a binary search along each
+//cut finds how many elements of each input come before it, so every thread merges the same number of elements no
+//matter how the inputs interleave. Equal elements always come from the earlier input first, which keeps the sort stable.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Runs of this many elements are insertion sorted before the bottom-up merging starts
+const int MERGE_SORT_RUN = 32;
+
+//Arrays at or below this size are merge sorted by a single thread
+const int MERGE_SORT_PARALLEL_CUTOFF = 65536;
+
+//SCRATCH SECTION ---------------------------------------------------------------------------
+
+//Structure to hold a merge scratch buffer
+//It belongs to the caller, who can pass the same one to repeated sorts so they don't pay for a fresh allocation and
+//page faults every time, and release it when done. Two sorts running at the same time need one buffer each.
+template <typename T>
+struct mergeScratchBuffer
+{
+    std::vector<T> buffer;
+};
+
+//Function to return room for at least size elements in scratch, growing it if needed
+template <typename T>
+inline T* reserveMergeScratch(mergeScratchBuffer<T> &scratch, std::ptrdiff_t size)
+{
+    if ((std::ptrdiff_t)scratch.buffer.size() < size)
+    {
+        scratch.buffer.resize(size);
+    }
+    return scratch.buffer.data();
+}
+
+//Function to free the memory held by scratch
+template <typename T>
+inline void releaseMergeScratch(mergeScratchBuffer<T> &scratch)
+{
+    std::vector<T>().swap(scratch.buffer);
+}
+
+//SEQUENTIAL SECTION ------------------------------------------------------------------------
+
+//Function to stably merge a[0..na - 1] and b[0..nb - 1] into output
+template <typename T, typename Less>
+inline void sequentialMerge(const T a[], std::ptrdiff_t na, const T b[], std::ptrdiff_t nb, T output[], Less less)
+{
+    std::ptrdiff_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb)
+    {
+        //Ties take from a, which is what keeps the merge stable
+        if (less(b[j], a[i]))
+        {
+            output[k++] = b[j++];
+        }
+        else
+        {
+            output[k++] = a[i++];
+        }
+    }
+    while (i < na)
+    {
+        output[k++] = a[i++];
+    }
+    while (j < nb)
+    {
+        output[k++] = b[j++];
+    }
+}
+
+//Function to stably sort data[0..n - 1] with a bottom-up merge sort, using scratch[0..n - 1] as the other buffer
+template <typename T, typename Less>
+inline void stableSortSequential(T data[], T scratch[], std::ptrdiff_t n, Less less)
+{
+    for (std::ptrdiff_t start = 0; start < n; start += MERGE_SORT_RUN)
+    {
+        insertionSort(data, start, std::min<std::ptrdiff_t>(n, start + MERGE_SORT_RUN) - 1, less);
+    }
+
+    T *source = data;
+    T *destination = scratch;
+    for (std::ptrdiff_t width = MERGE_SORT_RUN; width < n; width *= 2)
+    {
+        for (std::ptrdiff_t start = 0; start < n; start += 2 * width)
+        {
+            std::ptrdiff_t mid = std::min(n, start + width);
+            std::ptrdiff_t end = std::min(n, start + 2 * width);
+            sequentialMerge(source + start, mid - start, source + mid, end - mid, destination + start, less);
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != data)
+    {
+        std::copy(source, source + n, data);
+    }
+}
+
+//MERGE PATH SECTION ------------------------------------------------------------------------
+
+//Function to find where the merge path of a and b crosses the diagonal diag, returns how many of the first diag
+//outputs come from a (the rest, diag minus the result, come from b)
+template <typename T, typename Less>
+inline std::ptrdiff_t mergePathSplit(const T a[], std::ptrdiff_t na, const T b[], std::ptrdiff_t nb, std::ptrdiff_t diag, Less less)
+{
+    std::ptrdiff_t low = std::max<std::ptrdiff_t>(0, diag - nb);
+    std::ptrdiff_t high = std::min(diag, na);
+    while (low < high)
+    {
+        std::ptrdiff_t mid = low + (high - low) / 2;
+        //a[mid] is in the prefix if it doesn't come after b[diag - mid - 1] (ties go to a)
+        if (!less(b[diag - mid - 1], a[mid]))
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+//Function to merge this thread's equal slice of the output of merging a and b, called by every thread of the team
+template <typename T, typename Less>
+inline void mergePathSlice(const T a[], std::ptrdiff_t na, const T b[], std::ptrdiff_t nb, T output[], int tid, int threads, Less less)
+{
+    std::ptrdiff_t total = na + nb;
+    std::ptrdiff_t start = total * tid / threads;
+    std::ptrdiff_t end = total * (tid + 1) / threads;
+    std::ptrdiff_t startA = mergePathSplit(a, na, b, nb, start, less);
+    std::ptrdiff_t endA = mergePathSplit(a, na, b, nb, end, less);
+    sequentialMerge(a + startA, endA - startA, b + (start - startA), (end - endA) - (start - startA), output + start, less);
+}
+
+//Function to stably merge a[0..na - 1] and b[0..nb - 1] into output in parallel, using omp_get_max_threads() threads
+template <typename T, typename Less = std::less<T>>
+inline void parallelMerge(const T a[], std::ptrdiff_t na, const T b[], std::ptrdiff_t nb, T output[], Less less = Less())
+{
+    #pragma omp parallel
+    {
+        mergePathSlice(a, na, b, nb, output, omp_get_thread_num(), omp_get_num_threads(), less);
+    }
+}
+
+//K-WAY MERGE SECTION -----------------------------------------------------------------------
+
+//Structure to hold one sorted input of a k-way merge
+template <typename T>
+struct mergeSequence
+{
+    const T *data;
+    std::ptrdiff_t size;
+};
+
+//Function to find how many elements of each sequence come before output position rank in a stable k-way merge
+//Elements are ordered by value and then by sequence, so equal elements from an earlier sequence come first. The element
+//at the given rank sits in exactly one sequence, and within that sequence its rank rises with its position, so it is
+//found with a binary search per sequence, counting the elements before it in every other sequence.
+template <typename T, typename Less>
+inline void multiwaySplit(const std::vector<mergeSequence<T>> &sequences, std::ptrdiff_t rank, std::vector<std::ptrdiff_t> &positions, Less less)
+{
+    int k = (int)sequences.size();
+    positions.assign(k, 0);
+
+    std::ptrdiff_t total = 0;
+    for (int s = 0; s < k; s++)
+    {
+        total += sequences[s].size;
+    }
+    if (rank >= total)
+    {
+        for (int s = 0; s < k; s++)
+        {
+            positions[s] = sequences[s].size;
+        }
+        return;
+    }
+
+    //Number of elements of sequence other that come before value taken from sequence owner
+    auto countBefore = [&](int other, int owner, const T &value)
+    {
+        const T *begin = sequences[other].data;
+        const T *end = begin + sequences[other].size;
+        if (other < owner)
+        {
+            return (std::ptrdiff_t)(std::upper_bound(begin, end, value, less) - begin);
+        }
+        return (std::ptrdiff_t)(std::lower_bound(begin, end, value, less) - begin);
+    };
+
+    for (int owner = 0; owner < k; owner++)
+    {
+        std::ptrdiff_t low = 0, high = sequences[owner].size;
+        while (low < high)
+        {
+            std::ptrdiff_t mid = low + (high - low) / 2;
+            const T &value = sequences[owner].data[mid];
+            std::ptrdiff_t before = mid;
+            for (int other = 0; other < k; other++)
+            {
+                if (other != owner) before += countBefore(other, owner, value);
+            }
+
+            if (before == rank)
+            {
+                for (int other = 0; other < k; other++)
+                {
+                    positions[other] = (other == owner) ? mid : countBefore(other, owner, value);
+                }
+                return;
+            }
+            if (before < rank)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+    }
+}
+
+//Structure to hold a loser tree (tournament tree) over k sources
+//nodes[1..k - 1] hold the loser of the match played at that node and nodes[0] the overall winner. Sources sit at the
+//leaves k..2k - 1, so after the winner is taken only the matches on its path to the root are replayed, which is
+//log2(k) comparisons against a fixed path instead of the two per level a heap needs.
+struct loserTree
+{
+    int k;
+    std::vector<int> nodes;
+};
+
+//Function to build a loser tree over k sources
+//beats(x, y) returns true when source x's next element comes first (exhausted sources never win)
+template <typename Beats>
+inline void initLoserTree(loserTree &tree, int k, Beats beats)
+{
+    tree.k = k;
+    tree.nodes.assign(std::max(1, k), 0);
+    if (k <= 1)
+    {
+        return;
+    }
+
+    std::vector<int> winner(2 * k);
+    for (int leaf = 0; leaf < k; leaf++)
+    {
+        winner[k + leaf] = leaf;
+    }
+    for (int node = k - 1; node >= 1; node--)
+    {
+        int left = winner[2 * node];
+        int right = winner[2 * node + 1];
+        bool leftWins = beats(left, right);
+        winner[node] = leftWins ? left : right;
+        tree.nodes[node] = leftWins ? right : left;
+    }
+    tree.nodes[0] = winner[1];
+}
+
+//Function to replay the matches after the winning source has moved on to its next element
+template <typename Beats>
+inline void replayLoserTree(loserTree &tree, Beats beats)
+{
+    int current = tree.nodes[0];
+    for (int node = (current + tree.k) / 2; node >= 1; node /= 2)
+    {
+        if (beats(tree.nodes[node], current))
+        {
+            std::swap(tree.nodes[node], current);
+        }
+    }
+    tree.nodes[0] = current;
+}
+
+//Function to stably merge the parts sequences[s].data[from[s]..to[s] - 1] of every sequence into output
+//Ties go to the earlier sequence.
+template <typename T, typename Less>
+inline void sequentialMultiwayMerge(const std::vector<mergeSequence<T>> &sequences, const std::vector<std::ptrdiff_t> &from, const std::vector<std::ptrdiff_t> &to, T output[], Less less)
+{
+    int k = (int)sequences.size();
+    std::vector<std::ptrdiff_t> position(from);
+    std::ptrdiff_t total = 0;
+    for (int s = 0; s < k; s++)
+    {
+        total += to[s] - from[s];
+    }
+
+    auto beats = [&](int x, int y)
+    {
+        if (position[x] == to[x]) return false;
+        if (position[y] == to[y]) return true;
+        const T &valueX = sequences[x].data[position[x]];
+        const T &valueY = sequences[y].data[position[y]];
+        if (less(valueX, valueY)) return true;
+        if (less(valueY, valueX)) return false;
+        return x < y;
+    };
+
+    loserTree tree;
+    initLoserTree(tree, k, beats);
+    for (std::ptrdiff_t out = 0; out < total; out++)
+    {
+        int s = tree.nodes[0];
+        output[out] = sequences[s].data[position[s]++];
+        replayLoserTree(tree, beats);
+    }
+}
+
+//Function to stably merge every sequence into output in parallel, using omp_get_max_threads() threads
+//Each thread finds the split positions for the start and end of its equal output slice and merges just that slice.
+template <typename T, typename Less = std::less<T>>
+inline void parallelMultiwayMerge(const std::vector<mergeSequence<T>> &sequences, T output[], Less less = Less())
+{
+    std::ptrdiff_t total = 0;
+    for (size_t s = 0; s < sequences.size(); s++)
+    {
+        total += sequences[s].size;
+    }
+
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        int threads = omp_get_num_threads();
+        std::ptrdiff_t start = total * tid / threads;
+        std::ptrdiff_t end = total * (tid + 1) / threads;
+
+        std::vector<std::ptrdiff_t> from, to;
+        multiwaySplit(sequences, start, from, less);
+        multiwaySplit(sequences, end, to, less);
+        sequentialMultiwayMerge(sequences, from, to, output + start, less);
+    }
+}
+
+//PARALLEL STABLE SORT SECTION --------------------------------------------------------------
+
+//Function to stably sort array[0..size - 1] in parallel, using omp_get_max_threads() threads
+//1. The array is cut into one run per thread and each thread merge sorts its run
+//2. Pairs of runs are merged in rounds, every thread merging an equal merge path slice of every pair,
+//   ping-ponging between the array and the scratch buffer, which is copied back at the end if needed
+//scratchBuffer is kept for the caller to reuse, without one a buffer is allocated for this sort only.
+template <typename T, typename Less = std::less<T>>
+inline void parallelStableSort(T array[], std::ptrdiff_t size, Less less = Less(), mergeScratchBuffer<T> *scratchBuffer = NULL)
+{
+    int threads = omp_get_max_threads();
+    mergeScratchBuffer<T> ownBuffer;
+    T *scratch = reserveMergeScratch(scratchBuffer != NULL ? *scratchBuffer : ownBuffer, size);
+
+    if (size <= MERGE_SORT_PARALLEL_CUTOFF || threads == 1)
+    {
+        stableSortSequential(array, scratch, size, less);
+        return;
+    }
+
+    std::vector<std::ptrdiff_t> bounds(threads + 1);
+    for (int run = 0; run <= threads; run++)
+    {
+        bounds[run] = size * run / threads;
+    }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int tid = omp_get_thread_num();
+        int team = omp_get_num_threads();
+        int runs = team;
+        if (team != threads)
+        {
+            //Fewer threads than asked for, so the runs are re-cut to match the team actually running
+            #pragma omp single
+            for (int run = 0; run <= team; run++)
+            {
+                bounds[run] = size * run / team;
+            }
+        }
+
+        stableSortSequential(array + bounds[tid], scratch + bounds[tid], bounds[tid + 1] - bounds[tid], less);
+        #pragma omp barrier
+
+        T *source = array;
+        T *destination = scratch;
+        for (int width = 1; width < runs; width *= 2)
+        {
+            for (int first = 0; first < runs; first += 2 * width)
+            {
+                int mid = std::min(first + width, runs);
+                int last = std::min(first + 2 * width, runs);
+                mergePathSlice(source + bounds[first], bounds[mid] - bounds[first], source + bounds[mid], bounds[last] - bounds[mid],
+                               destination + bounds[first], tid, team, less);
+            }
+            #pragma omp barrier
+            std::swap(source, destination);
+        }
+
+        if (source != array)
+        {
+            std::ptrdiff_t start = size * tid / team;
+            std::ptrdiff_t end = size * (tid + 1) / team;
+            std::copy(source + start, source + end, array + start);
+        }
+    }
+}
+
+#endif
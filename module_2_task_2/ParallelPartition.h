@@ -0,0 +1,134 @@
+#ifndef PARALLEL_PARTITION_H
+#define PARALLEL_PARTITION_H
+
+#include <omp.h>
+#include <vector>
+#include <algorithm>
+#include "SortEngine.h"
+
+//Cooperative multi-threaded partition for the top levels of the OpenMP QuickSort.
+//The work is split into OpenMP tasks so it can be called from inside the task recursion, where a nested
+//parallel region would only get a single thread. Each phase waits in a taskgroup rather than a taskwait, so it only
+//waits for its own chunk tasks and not for sibling tasks the caller spawned before calling it.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Subranges above this size are partitioned cooperatively instead of by a single thread
+const int PARALLEL_PARTITION_CUTOFF = 1000000;
+
+//Smallest chunk of the range a single partition task is given
+const int PARALLEL_PARTITION_MIN_CHUNK = 65536;
+
+//PARALLEL PARTITION SECTION ----------------------------------------------------------------
+
+//Function to three-way partition array[low..high] around pivot using every thread in the current team
+//scratch must have room for the same [low..high] range, and has the same result contract as partitionThreeWay.
+//1. Blockwise classification: each chunk counts its elements that are less than and equal to the pivot
+//2. Prefix sums over the chunk counts give every chunk its own output offsets in the three regions
+//3. Parallel scatter: each chunk writes its elements to their region in scratch, which is then copied back
+inline void parallelPartition(int array[], int scratch[], std::ptrdiff_t low, std::ptrdiff_t high, int pivot, std::ptrdiff_t &lessEnd, std::ptrdiff_t &greaterStart)
+{
+    std::ptrdiff_t count = high - low + 1;
+    int numChunks = (int)std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(4 * omp_get_num_threads(), count / PARALLEL_PARTITION_MIN_CHUNK));
+    std::ptrdiff_t chunkSize = (count + numChunks - 1) / numChunks;
+
+    std::vector<std::ptrdiff_t> lessCount(numChunks, 0);
+    std::vector<std::ptrdiff_t> equalCount(numChunks, 0);
+    std::ptrdiff_t *less = lessCount.data();
+    std::ptrdiff_t *equal = equalCount.data();
+
+    //Phase 1: classification counts per chunk
+    #pragma omp taskgroup
+    {
+        for (int chunk = 0; chunk < numChunks; chunk++)
+        {
+            #pragma omp task firstprivate(chunk)
+            {
+                std::ptrdiff_t start = low + chunk * chunkSize;
+                std::ptrdiff_t end = std::min(high + 1, start + chunkSize);
+                std::ptrdiff_t lessTotal = 0, equalTotal = 0;
+                for (std::ptrdiff_t i = start; i < end; i++)
+                {
+                    lessTotal += (array[i] < pivot);
+                    equalTotal += (array[i] == pivot);
+                }
+                less[chunk] = lessTotal;
+                equal[chunk] = equalTotal;
+            }
+        }
+    }
+
+    //Phase 2: exclusive prefix sums give each chunk its write positions
+    std::vector<std::ptrdiff_t> lessOffset(numChunks), equalOffset(numChunks), greaterOffset(numChunks);
+    std::ptrdiff_t totalLess = 0, totalEqual = 0;
+    for (int chunk = 0; chunk < numChunks; chunk++)
+    {
+        totalLess += less[chunk];
+        totalEqual += equal[chunk];
+    }
+
+    std::ptrdiff_t lessPos = low, equalPos = low + totalLess, greaterPos = low + totalLess + totalEqual;
+    for (int chunk = 0; chunk < numChunks; chunk++)
+    {
+        std::ptrdiff_t start = low + chunk * chunkSize;
+        std::ptrdiff_t end = std::min(high + 1, start + chunkSize);
+        lessOffset[chunk] = lessPos;
+        equalOffset[chunk] = equalPos;
+        greaterOffset[chunk] = greaterPos;
+        lessPos += less[chunk];
+        equalPos += equal[chunk];
+        greaterPos += (end - start) - less[chunk] - equal[chunk];
+    }
+    std::ptrdiff_t *lessAt = lessOffset.data();
+    std::ptrdiff_t *equalAt = equalOffset.data();
+    std::ptrdiff_t *greaterAt = greaterOffset.data();
+
+    //Phase 3: scatter every chunk into its slots in scratch
+    #pragma omp taskgroup
+    {
+        for (int chunk = 0; chunk < numChunks; chunk++)
+        {
+            #pragma omp task firstprivate(chunk)
+            {
+                std::ptrdiff_t start = low + chunk * chunkSize;
+                std::ptrdiff_t end = std::min(high + 1, start + chunkSize);
+                std::ptrdiff_t l = lessAt[chunk], e = equalAt[chunk], g = greaterAt[chunk];
+                for (std::ptrdiff_t i = start; i < end; i++)
+                {
+                    int value = array[i];
+                    if (value < pivot)
+                    {
+                        scratch[l++] = value;
+                    }
+                    else if (value == pivot)
+                    {
+                        scratch[e++] = value;
+                    }
+                    else
+                    {
+                        scratch[g++] = value;
+                    }
+                }
+            }
+        }
+    }
+
+    //Copy the partitioned range back in parallel
+    #pragma omp taskgroup
+    {
+        for (int chunk = 0; chunk < numChunks; chunk++)
+        {
+            #pragma omp task firstprivate(chunk)
+            {
+                std::ptrdiff_t start = low + chunk * chunkSize;
+                std::ptrdiff_t end = std::min(high + 1, start + chunkSize);
+                std::copy(scratch + start, scratch + end, array + start);
+            }
+        }
+    }
+
+    lessEnd = low + totalLess;
+    greaterStart = low + totalLess + totalEqual - 1;
+}
+
+#endif
@@ -0,0 +1,262 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "SortEngine.h"
+
+using namespace std::chrono;
+using namespace std;
+
+//Function to format numbers with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    //Insert commas from right to left
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Function to initialize array with random values
+void initializeArray(int array[], int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        array[i] = rand();
+    }
+}
+
+//BRANCH MISS COUNTER SECTION ---------------------------------------------------------------
+
+//Function to open a hardware branch miss counter for this thread, returns -1 if perf events are unavailable
+int openBranchMissCounter()
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+//Function to reset and start the counter
+void startCounter(int fd)
+{
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+//Function to stop the counter and return its value (-1 if unavailable)
+long long stopCounter(int fd)
+{
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    long long value = 0;
+    if (read(fd, &value, sizeof(value)) != sizeof(value))
+    {
+        return -1;
+    }
+    return value;
+}
+
+//PARTITION SECTION -------------------------------------------------------------------------
+
+//Original Lomuto partition (last element pivot), kept here as the baseline
+int partitionLomuto(int array[], int low, int high)
+{
+    int pivot = array[high];
+    int i = (low - 1);
+
+    for (int j = low; j <= high - 1; j++)
+    {
+        if (array[j] <= pivot)
+        {
+            i++;
+            swap(array[i], array[j]);
+        }
+    }
+    swap(array[i + 1], array[high]);
+    return (i + 1);
+}
+
+//Function to run one partition pass over the whole array with the given method
+//0 = Lomuto, 1 = three-way, 2 = block, 3 = SIMD
+void partitionOnce(int method, int array[], int size)
+{
+    ptrdiff_t lessEnd, greaterStart;
+    if (method == 0)
+    {
+        partitionLomuto(array, 0, size - 1);
+    }
+    else if (method == 1)
+    {
+        partitionThreeWay(array, 0, size - 1, selectPivot(array, 0, size - 1), lessEnd, greaterStart);
+    }
+    else if (method == 2)
+    {
+        partitionBlock(array, 0, size - 1, selectPivot(array, 0, size - 1), lessEnd, greaterStart);
+    }
+    else
+    {
+        partitionSimd(array, 0, size - 1, selectPivot(array, 0, size - 1), lessEnd, greaterStart);
+    }
+}
+
+//Original recursive QuickSort on the Lomuto partition
+void lomutoQuickSort(int array[], int low, int high)
+{
+    if (low < high)
+    {
+        int pivot = partitionLomuto(array, low, high);
+        lomutoQuickSort(array, low, pivot - 1);
+        lomutoQuickSort(array, pivot + 1, high);
+    }
+}
+
+//Function to fully sort the array with the given method
+//Lomuto uses the original recursive QuickSort, the others use the engine with that partition scheme
+void sortWith(int method, int array[], int size)
+{
+    if (method == 0)
+    {
+        lomutoQuickSort(array, 0, size - 1);
+        return;
+    }
+    PartitionScheme schemes[] = {PARTITION_THREE_WAY, PARTITION_THREE_WAY, PARTITION_BLOCK, PARTITION_SIMD};
+    partitionScheme = schemes[method];
+    introSort(array, 0, size - 1);
+}
+
+//Main function that calls other functions
+int main()
+{
+    string filename = "PartitionBenchmarkResults.txt";
+    ofstream outfile(filename);
+    if (!outfile.is_open())
+    {
+        cout << "Error: Could not create output file " << filename << endl;
+        return 1;
+    }
+
+    int counter = openBranchMissCounter();
+    if (counter < 0)
+    {
+        cout << "Branch miss counter unavailable (perf_event_open failed), only times will be reported" << endl;
+    }
+
+    outfile << "---------------------------------------------" << endl;
+    outfile << "Partition Benchmark Results" << endl;
+    outfile << "SIMD instruction set: " << simdLevelName(activeSimdLevel()) << endl;
+    outfile << "---------------------------------------------" << endl;
+    outfile << endl;
+
+    cout << "Starting Partition Benchmark" << endl;
+    cout << "SIMD instruction set: " << simdLevelName(activeSimdLevel()) << endl;
+    cout << endl;
+
+    const char* methodNames[] = {"Lomuto", "Three-Way", "Block", "SIMD"};
+    int numMethods = 4;
+
+    int testSizes[] = {1000, 10000, 100000, 1000000, 10000000};
+    int numSizes = sizeof(testSizes) / sizeof(testSizes[0]);
+
+    outfile << "| Array Size | Method | Partition (us) | Partition Branch Misses | Sort (us) | Sort Branch Misses |" << endl;
+    outfile << "|------------|--------|----------------|-------------------------|-----------|--------------------|" << endl;
+
+    for (int sizeIndex = 0; sizeIndex < numSizes; sizeIndex++)
+    {
+        int size = testSizes[sizeIndex];
+        cout << "Testing array size: " << formatWithCommas(size) << endl;
+
+        int* original = new int[size];
+        int* array = new int[size];
+
+        for (int method = 0; method < numMethods; method++)
+        {
+            long long partitionTime = 0, partitionMisses = 0;
+            long long sortTime = 0, sortMisses = 0;
+
+            for (int run = 0; run < 10; run++)
+            {
+                //Every method sees the same input in a given run
+                srand(run + 1);
+                initializeArray(original, size);
+
+                memcpy(array, original, size * sizeof(int));
+                startCounter(counter);
+                auto start = high_resolution_clock::now();
+                partitionOnce(method, array, size);
+                auto stop = high_resolution_clock::now();
+                partitionMisses += stopCounter(counter);
+                partitionTime += duration_cast<microseconds>(stop - start).count();
+
+                memcpy(array, original, size * sizeof(int));
+                startCounter(counter);
+                start = high_resolution_clock::now();
+                sortWith(method, array, size);
+                stop = high_resolution_clock::now();
+                sortMisses += stopCounter(counter);
+                sortTime += duration_cast<microseconds>(stop - start).count();
+
+                for (int i = 0; i < size - 1; i++)
+                {
+                    if (array[i] > array[i + 1])
+                    {
+                        cout << methodNames[method] << " did not sort array size " << formatWithCommas(size) << " correctly" << endl;
+                        break;
+                    }
+                }
+            }
+
+            string partitionMissText = (counter < 0) ? "n/a" : formatWithCommas(partitionMisses / 10);
+            string sortMissText = (counter < 0) ? "n/a" : formatWithCommas(sortMisses / 10);
+
+            outfile << "| " << formatWithCommas(size) << " | " << methodNames[method]
+                    << " | " << formatWithCommas(partitionTime / 10) << " | " << partitionMissText
+                    << " | " << formatWithCommas(sortTime / 10) << " | " << sortMissText << " |" << endl;
+
+            cout << "  " << methodNames[method] << " - Partition: " << formatWithCommas(partitionTime / 10) << " us (" << partitionMissText
+                 << " misses), Sort: " << formatWithCommas(sortTime / 10) << " us (" << sortMissText << " misses)" << endl;
+        }
+
+        delete[] original;
+        delete[] array;
+    }
+
+    if (counter >= 0)
+    {
+        close(counter);
+    }
+
+    outfile << endl;
+    outfile.close();
+    cout << "\nResults written to: " << filename << endl;
+
+    return 0;
+}
@@ -6,11 +6,45 @@
 #include <iomanip>
 #include <fstream>
 #include <vector>
+#include <atomic>
+#include <cstddef>
 #include <omp.h>
+#include "SortEngine.h"
+#include "ParallelPartition.h"
+#include "SampleSort.h"
+#include "RadixSort.h"
+#include "MergeSort.h"
+#include "AdaptiveSort.h"
+#include "Distributions.h"
+#include "ArrayStorage.h"
+#include "SortVerify.h"
 
 using namespace std::chrono;
 using namespace std;
 
+//Sort modes the benchmark can run, chosen on the command line
+enum SortMode
+{
+    MODE_QUICKSORT,
+    MODE_SAMPLESORT,
+    MODE_LSD_RADIX,
+    MODE_MSD_RADIX,
+    MODE_STABLE_MERGE,
+    MODE_ADAPTIVE
+};
+
+SortMode sortMode = MODE_QUICKSORT;
+
+//Merge buffer for the stable and adaptive sorts, kept between the runs of one array size and then released
+mergeScratchBuffer<int> mergeScratch;
+
+//Distribution the test arrays are generated from, chosen on the command line
+InputDistribution inputDistribution = DIST_RANDOM;
+
+//Memory the test array and the QuickSort scratch buffer are allocated from, and the file used for BACKING_FILE
+ArrayBacking arrayBacking = BACKING_HEAP;
+string backingPath = "QuickSortArray.bin";
+
 //Function to format numbers with commas
 string formatWithCommas(long long number)
 {
@@ -33,80 +67,384 @@ string formatWithCommas(long long number)
     return result;
 }
 
-//Function to initialize array with random values
-void initializeArray(int array[], int size)
+//Function to initialize array from the selected input distribution, with a fresh seed each time
+void initializeArray(int array[], ptrdiff_t size)
+{
+    generateDistribution(array, size, inputDistribution, ((unsigned long long)rand() << 31) | rand());
+}
+
+//TASK GRANULARITY SECTION ------------------------------------------------------------------
+
+//Smallest subarray worth handing out as a task, whatever the array size and thread count
+const int TASK_MIN_GRAIN = 16384;
+
+//Tasks aimed for per thread, subarrays below size / (threads * TASKS_PER_THREAD) are not split any further
+const int TASKS_PER_THREAD = 4;
+
+//Structure to hold the spawning limits and counters for one parallel sort
+struct taskControl
+{
+    ptrdiff_t grain;                //Subarrays at or below this size are finished sequentially
+    int freeDepth;                  //Recursion levels above this depth always spawn a task
+    int threads;                    //Threads in the team
+    atomic<int> outstanding;        //Tasks spawned and not yet finished
+    atomic<long long> created;      //Tasks spawned in total
+};
+
+//Function to set up the spawning limits for sorting size elements with the given number of threads
+//The grain grows with the array so each thread gets about TASKS_PER_THREAD tasks rather than a fixed size,
+//and the free depth is enough levels for every thread to get one task from a balanced split.
+void initTaskControl(taskControl &control, ptrdiff_t size, int threads)
+{
+    control.grain = max<ptrdiff_t>(TASK_MIN_GRAIN, size / (threads * TASKS_PER_THREAD));
+    control.freeDepth = 0;
+    while ((1 << control.freeDepth) < threads)
+    {
+        control.freeDepth++;
+    }
+    control.threads = threads;
+    control.outstanding = 0;
+    control.created = 0;
+}
+
+//Function to decide whether a split at this depth should become a task
+//Below the free depth a task is only worth creating when some worker is idle (fewer tasks in flight than the other
+//threads), otherwise the current thread just keeps going and the split costs nothing.
+bool shouldSpawnTask(const taskControl &control, int depth)
 {
-    for (int i = 0; i < size; i++)
+    if (depth < control.freeDepth)
     {
-        array[i] = rand();
+        return true;
     }
+    return control.outstanding.load(memory_order_relaxed) < control.threads - 1;
 }
 
-//Function to perform partitioning
-int partition(int array[], int low, int high)
+//OPENMP QUICKSORT SECTION ------------------------------------------------------------------
+
+//OpenMP QuickSort function with adaptive task granularity
+//Large subarrays are split with the engine's pivot selection and partition, anything at or below the grain
+//(or past the depth limit) is finished sequentially by the engine. After a split the smaller side becomes a task if
+//shouldSpawnTask allows it and the current thread carries on with the larger side.
+//Subarrays above PARALLEL_PARTITION_CUTOFF are partitioned cooperatively by the whole team using scratch,
+//so the top recursion levels no longer run on one or two threads.
+void quickSort(int array[], int scratch[], ptrdiff_t low, ptrdiff_t high, int depthLimit, int depth, taskControl &control)
 {
-    int pivot = array[high];
-    int i = (low - 1);
+    if (high - low + 1 <= control.grain || depthLimit == 0)
+    {
+        introSort(array, low, high, depthLimit);
+        return;
+    }
+
+    ptrdiff_t lessEnd, greaterStart;
+    if (scratch != NULL && high - low + 1 > PARALLEL_PARTITION_CUTOFF)
+    {
+        parallelPartition(array, scratch, low, high, selectPivot(array, low, high), lessEnd, greaterStart);
+    }
+    else
+    {
+        partitionRange(array, low, high, lessEnd, greaterStart);
+    }
 
-    for (int j = low; j <= high - 1; j++)
+    ptrdiff_t smallLow = low, smallHigh = lessEnd - 1;
+    ptrdiff_t largeLow = greaterStart + 1, largeHigh = high;
+    if (smallHigh - smallLow > largeHigh - largeLow)
     {
-        if (array[j] <= pivot)
+        swap(smallLow, largeLow);
+        swap(smallHigh, largeHigh);
+    }
+
+    if (smallHigh > smallLow && shouldSpawnTask(control, depth))
+    {
+        control.outstanding++;
+        control.created++;
+
+        #pragma omp task shared(control)
         {
-            i++;
-            swap(array[i], array[j]);
+            quickSort(array, scratch, smallLow, smallHigh, depthLimit - 1, depth + 1, control);
+            control.outstanding--;
         }
     }
-    swap(array[i + 1], array[high]);
-    return (i + 1);
+    else
+    {
+        quickSort(array, scratch, smallLow, smallHigh, depthLimit - 1, depth + 1, control);
+    }
+
+    quickSort(array, scratch, largeLow, largeHigh, depthLimit - 1, depth + 1, control);
 }
 
-//OpenMP QuickSort function with threshold for small arrays
-void quickSort(int array[], int low, int high)
+//Function to start the OpenMP QuickSort on array[low..high], returns the number of tasks created
+//Must be called from inside a parallel region (by a single thread). The scratch buffer is indexed like the array
+//and is only allocated (from the same backing as the array) when the array is large enough for the parallel
+//partition to be used.
+long long quickSort(int array[], ptrdiff_t low, ptrdiff_t high)
 {
-    const int Threshold = 100000;
-    
-    if (low < high)
+    ptrdiff_t count = high - low + 1;
+    int threads = omp_get_num_threads();
+    arrayStorage scratchStorage;
+    int* scratch = NULL;
+    if (count > PARALLEL_PARTITION_CUTOFF && threads > 1 && allocateArrayStorage(scratchStorage, high + 1, arrayBacking, backingPath + ".scratch"))
     {
-        int pivot = partition(array, low, high);
+        scratch = scratchStorage.data;
+    }
 
-        if (high - low > Threshold)
-        {
-            #pragma omp task
-            quickSort(array, low, pivot - 1);
-            
-            #pragma omp task
-            quickSort(array, pivot + 1, high);
-            
-            #pragma omp taskwait
-        }
-        else
-        {
-            quickSort(array, low, pivot - 1);
-            quickSort(array, pivot + 1, high);
-        }
+    taskControl control;
+    initTaskControl(control, count, threads);
+
+    //The taskgroup waits for every task spawned below, so the recursion never waits for the sorts it spawns. The only
+    //waits inside it are the parallel partition's taskgroups, which cover just that partition's own chunk tasks
+    #pragma omp taskgroup
+    {
+        quickSort(array, scratch, low, high, introSortDepthLimit(count), 0, control);
+    }
+
+    if (scratch != NULL)
+    {
+        freeArrayStorage(scratchStorage);
+    }
+    return control.created;
+}
+
+//Function to return the display name of a sort mode (also used for the results file name)
+string sortModeName(SortMode mode)
+{
+    switch (mode)
+    {
+        case MODE_SAMPLESORT:
+            return "SampleSort";
+        case MODE_LSD_RADIX:
+            return "LSDRadixSort";
+        case MODE_MSD_RADIX:
+            return "MSDRadixSort";
+        case MODE_STABLE_MERGE:
+            return "StableMergeSort";
+        case MODE_ADAPTIVE:
+            return "AdaptiveSort";
+        default:
+            return "QuickSort";
+    }
+}
+
+//Function to sort the whole array with the selected sort mode, returns the number of QuickSort tasks created
+//Arrays no bigger than one task are sorted without starting a parallel region at all.
+long long runSort(int array[], ptrdiff_t size)
+{
+    if (sortMode == MODE_SAMPLESORT)
+    {
+        sampleSort(array, size);
+        return 0;
+    }
+    if (sortMode == MODE_LSD_RADIX)
+    {
+        lsdRadixSort(array, size);
+        return 0;
+    }
+    if (sortMode == MODE_MSD_RADIX)
+    {
+        msdRadixSort(array, size);
+        return 0;
+    }
+    if (sortMode == MODE_STABLE_MERGE)
+    {
+        parallelStableSort(array, size, less<int>(), &mergeScratch);
+        return 0;
     }
+    //The adaptive sort leaves arrays without enough presorted structure to the QuickSort below
+    if (sortMode == MODE_ADAPTIVE && adaptiveSort(array, size, less<int>(), &mergeScratch))
+    {
+        return 0;
+    }
+
+    if (size <= TASK_MIN_GRAIN || omp_get_max_threads() == 1)
+    {
+        introSort(array, 0, size - 1);
+        return 0;
+    }
+
+    long long tasks = 0;
+    #pragma omp parallel
+    {
+        #pragma omp single
+        tasks = quickSort(array, 0, size - 1);
+    }
+    return tasks;
 }
 
-//Function to verify if array is sorted (not timed)
-bool verifySorted(int array[], int size)
+//Function to run every sort mode against every input distribution with the given number of threads
+//Each cell is the average of 10 sorts of a freshly generated array, reported as throughput so rows and columns can be
+//compared directly. The matrix is printed and written to SortSweepResults.txt.
+int runDistributionSweep(int threads)
 {
-    for (int i = 0; i < size - 1; i++)
+    string filename = "SortSweepResults.txt";
+    ofstream outfile(filename);
+    if (!outfile.is_open())
     {
-        if (array[i] > array[i + 1])
+        cout << "Error: Could not create output file " << filename << endl;
+        return 1;
+    }
+
+    const int size = 1000000;
+    SortMode modes[] = {MODE_QUICKSORT, MODE_SAMPLESORT, MODE_LSD_RADIX, MODE_MSD_RADIX, MODE_STABLE_MERGE, MODE_ADAPTIVE};
+    int numModes = sizeof(modes) / sizeof(modes[0]);
+    omp_set_num_threads(threads);
+
+    outfile << "---------------------------------------------" << endl;
+    outfile << "Sort Mode / Input Distribution Sweep" << endl;
+    outfile << "Partition scheme: " << partitionSchemeName(partitionScheme) << endl;
+    outfile << "Threads: " << threads << ", Array size: " << formatWithCommas(size) << endl;
+    outfile << "Throughput in M elements/s, averaged over 10 runs" << endl;
+    outfile << "---------------------------------------------" << endl;
+    outfile << endl;
+
+    cout << "Starting sort mode / input distribution sweep" << endl;
+    cout << "Threads: " << threads << ", Array size: " << formatWithCommas(size) << endl;
+    cout << endl;
+
+    outfile << "| Sort Mode |";
+    cout << left << setw(16) << "Sort Mode";
+    for (int d = 0; d < DIST_COUNT; d++)
+    {
+        outfile << " " << distributionName((InputDistribution)d) << " |";
+        cout << right << setw(14) << distributionName((InputDistribution)d);
+    }
+    outfile << endl;
+    cout << endl;
+
+    outfile << "|-----------|";
+    for (int d = 0; d < DIST_COUNT; d++)
+    {
+        outfile << "------------|";
+    }
+    outfile << endl;
+
+    int* array = new int[size];
+    for (int m = 0; m < numModes; m++)
+    {
+        sortMode = modes[m];
+        outfile << "| " << sortModeName(sortMode) << " |";
+        cout << left << setw(16) << sortModeName(sortMode) << flush;
+
+        for (int d = 0; d < DIST_COUNT; d++)
         {
-            return false;
+            inputDistribution = (InputDistribution)d;
+            long long totalTime = 0;
+            bool sorted = true;
+            for (int run = 0; run < 10; run++)
+            {
+                initializeArray(array, size);
+                unsigned long long inputHash = multisetHash(array, size);
+                auto start = high_resolution_clock::now();
+                runSort(array, size);
+                auto stop = high_resolution_clock::now();
+                totalTime += duration_cast<microseconds>(stop - start).count();
+                sorted = sorted && verifySortedPermutation(array, size, inputHash);
+            }
+
+            double throughput = (totalTime > 0) ? (double)size * 10 / totalTime : 0.0;
+            outfile << " " << fixed << setprecision(1) << throughput << (sorted ? "" : " (unsorted)") << " |";
+            cout << right << setw(14) << fixed << setprecision(1) << throughput << flush;
+            if (!sorted)
+            {
+                cout << "\n" << sortModeName(sortMode) << " did not sort the " << distributionName(inputDistribution) << " input correctly" << endl;
+            }
         }
+        outfile << endl;
+        cout << endl;
     }
-    return true;
+    delete[] array;
+    releaseMergeScratch(mergeScratch);
+
+    outfile << endl;
+    outfile.close();
+    cout << "\nResults written to: " << filename << endl;
+    return 0;
 }
 
 //Main function that calls other functions
-int main()
+int main(int argc, char* argv[])
 {
     //Setup text output file and write heading
     srand(time(0));
 
-    string filename = "QuickSortOpenMPResults.txt";
+    //Partition scheme and sort mode can be chosen per run, "block" selects the branchless block partition,
+    //"simd" the AVX2 / AVX-512 partition and sorting networks, "samplesort" the in-place parallel samplesort, "radix" / "msdradix" the LSD / MSD radix sorts
+    //"stablesort" the stable parallel merge sort and "adaptive" the run-detecting adaptive merge sort
+    //A distribution name ("sorted", "reverse", "nearlysorted", "fewunique", "organpipe", "zipf", "gaussian",
+    //"median3killer") generates the arrays from that distribution instead of uniform random values
+    //"sweep" runs every sort mode against every distribution instead and writes a throughput matrix
+    //"hugepages" allocates the array and scratch buffer in huge pages, "mmapfile" (or "mmapfile=<path>") in a mapped file
+    //A number tests that one array size instead of the default sizes, up to the billions of elements memory allows
+    //Thread counts above the hardware threads are capped unless "oversubscribe" is given
+    bool oversubscribe = false;
+    bool sweep = false;
+    long long customSize = 0;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        string option = argv[arg];
+        if (option == "oversubscribe")
+        {
+            oversubscribe = true;
+        }
+        else if (option == "block")
+        {
+            partitionScheme = PARTITION_BLOCK;
+        }
+        else if (option == "simd")
+        {
+            partitionScheme = PARTITION_SIMD;
+        }
+        else if (option == "samplesort")
+        {
+            sortMode = MODE_SAMPLESORT;
+        }
+        else if (option == "radix")
+        {
+            sortMode = MODE_LSD_RADIX;
+        }
+        else if (option == "msdradix")
+        {
+            sortMode = MODE_MSD_RADIX;
+        }
+        else if (option == "stablesort")
+        {
+            sortMode = MODE_STABLE_MERGE;
+        }
+        else if (option == "adaptive")
+        {
+            sortMode = MODE_ADAPTIVE;
+        }
+        else if (option == "sweep")
+        {
+            sweep = true;
+        }
+        else if (option == "hugepages")
+        {
+            arrayBacking = BACKING_HUGE_PAGES;
+        }
+        else if (option.compare(0, 8, "mmapfile") == 0)
+        {
+            arrayBacking = BACKING_FILE;
+            if (option.size() > 9 && option[8] == '=')
+            {
+                backingPath = option.substr(9);
+            }
+        }
+        else if (option.find_first_not_of("0123456789") == string::npos)
+        {
+            customSize = stoll(option);
+        }
+        else
+        {
+            parseDistribution(option, inputDistribution);
+        }
+    }
+
+    int hardwareThreads = omp_get_num_procs();
+    if (sweep)
+    {
+        return runDistributionSweep(oversubscribe ? omp_get_max_threads() : min(omp_get_max_threads(), hardwareThreads));
+    }
+
+    string filename = sortModeName(sortMode) + (inputDistribution != DIST_RANDOM ? distributionName(inputDistribution) : "") + "OpenMPResults.txt";
     ofstream outfile(filename);
     if (!outfile.is_open())
     {
@@ -115,60 +453,100 @@ int main()
     }
 
     outfile << "---------------------------------------------" << endl;
-    outfile << "OpenMP QuickSort Results" << endl;
+    outfile << "OpenMP " << sortModeName(sortMode) << " Results" << endl;
+    outfile << "Partition scheme: " << partitionSchemeName(partitionScheme) << endl;
+    outfile << "Input distribution: " << distributionName(inputDistribution) << endl;
+    outfile << "Array backing: " << arrayBackingName(arrayBacking) << endl;
+    if (partitionScheme == PARTITION_SIMD)
+    {
+        outfile << "SIMD instruction set: " << simdLevelName(activeSimdLevel()) << endl;
+    }
+    outfile << "Hardware threads: " << hardwareThreads << (oversubscribe ? " (oversubscription allowed)" : "") << endl;
     outfile << "---------------------------------------------" << endl;
 
     outfile << endl;
 
-    cout << "Starting OpenMP QuickSort" << endl;
+    cout << "Starting OpenMP " << sortModeName(sortMode) << endl;
+    cout << "Partition scheme: " << partitionSchemeName(partitionScheme) << endl;
+    cout << "Input distribution: " << distributionName(inputDistribution) << endl;
+    cout << "Array backing: " << arrayBackingName(arrayBacking) << endl;
+    if (partitionScheme == PARTITION_SIMD)
+    {
+        cout << "SIMD instruction set: " << simdLevelName(activeSimdLevel()) << endl;
+    }
     cout << "Number of threads: " << omp_get_max_threads() << endl;
+    cout << "Hardware threads: " << hardwareThreads << (oversubscribe ? " (oversubscription allowed)" : "") << endl;
     cout << endl;
 
     //Inputs array sizes and thread counts to test
     int threadCounts[] = {2, 6, 10, 16, 30, 50, 100};
     int numThreadCounts = sizeof(threadCounts) / sizeof(threadCounts[0]);
 
-    int testSizes[] = {10, 100, 1000, 10000, 100000, 1000000, 10000000};
-    int numSizes = sizeof(testSizes) / sizeof(testSizes[0]);    
+    vector<long long> testSizes = {10, 100, 1000, 10000, 100000, 1000000, 10000000};
+    if (customSize > 0)
+    {
+        testSizes = {customSize};
+    }
+    int numSizes = (int)testSizes.size();
 
     vector<vector<long long>> results(numSizes, vector<long long>(numThreadCounts, 0));
 
     for (int sizeIndex = 0; sizeIndex < numSizes; sizeIndex++)
     {
-        int size = testSizes[sizeIndex];
+        ptrdiff_t size = testSizes[sizeIndex];
 
         cout << "Testing array size: " << formatWithCommas(size) << endl;
 
         outfile << "Array Size: " << formatWithCommas(size) << endl;
         outfile << "------------------------" << endl;
 
-        int* array = new int[size];
+        arrayStorage arrayMemory;
+        if (!allocateArrayStorage(arrayMemory, size, arrayBacking, backingPath))
+        {
+            return 1;
+        }
+        if (arrayMemory.backing == BACKING_HUGE_PAGES)
+        {
+            cout << (arrayMemory.explicitHugePages ? "  Explicit huge pages" : "  Transparent huge pages (none reserved)") << endl;
+        }
+        int* array = arrayMemory.data;
 
         for (int threadIndex = 0; threadIndex < numThreadCounts; threadIndex++)
         {
             int numThreads = threadCounts[threadIndex];
-            omp_set_num_threads(numThreads);
+            int runThreads = oversubscribe ? numThreads : min(numThreads, hardwareThreads);
+            omp_set_num_threads(runThreads);
 
-            cout << "  Threads: " << numThreads << endl;
+            cout << "  Threads: " << numThreads;
+            if (runThreads != numThreads)
+            {
+                cout << " (capped to " << runThreads << ")";
+            }
+            cout << endl;
 
             long long durations[10];
+            long long totalTasks = 0;
+            int unsortedRuns = 0;
+            int corruptedRuns = 0;
 
             for (int run = 0; run < 10; run++)
             {
                 initializeArray(array, size);
+                unsigned long long inputHash = multisetHash(array, size);
 
                 auto start = high_resolution_clock::now();
 
-                #pragma omp parallel
-                {
-                    #pragma omp single
-                    quickSort(array, 0, size - 1);
-                }
+                totalTasks += runSort(array, size);
 
                 auto stop = high_resolution_clock::now();
 
                 auto duration = duration_cast<microseconds>(stop - start);
                 durations[run] = duration.count();
+
+                //Verifies every run (not timed): in order, and no elements lost or duplicated
+                sortCheck check = checkSortedPermutation(array, size, inputHash);
+                unsortedRuns += (check.descents != 0);
+                corruptedRuns += !check.permutation;
             }
 
             //Calculates average
@@ -182,19 +560,34 @@ int main()
 
             results[sizeIndex][threadIndex] = avgLong;
 
-            outfile << "Threads " << numThreads << " - Average: " << formatWithCommas(avgLong) << " microseconds" << endl;
+            outfile << "Threads " << numThreads;
+            if (runThreads != numThreads)
+            {
+                outfile << " (capped to " << runThreads << ")";
+            }
+            outfile << " - Average: " << formatWithCommas(avgLong) << " microseconds";
+            if (sortMode == MODE_QUICKSORT)
+            {
+                outfile << ", Tasks per run: " << formatWithCommas(totalTasks / 10);
+            }
+            outfile << endl;
 
-            //Verifies array is sorted correctly (check the array from the last timed run)
-            if (!verifySorted(array, size))
+            if (unsortedRuns > 0)
+            {
+                outfile << "Array was not sorted correctly in " << unsortedRuns << " of 10 runs" << endl;
+                cout << "Array size " << formatWithCommas(size) << " with " << numThreads << " threads was not sorted correctly in " << unsortedRuns << " of 10 runs" << endl;
+            }
+            if (corruptedRuns > 0)
             {
-                outfile << "Array was not sorted correctly" << endl;
-                cout << "Array size " << formatWithCommas(size) << " with " << numThreads << " threads was not sorted correctly" << endl;
+                outfile << "Output was not a permutation of the input in " << corruptedRuns << " of 10 runs" << endl;
+                cout << "Array size " << formatWithCommas(size) << " with " << numThreads << " threads lost or duplicated elements in " << corruptedRuns << " of 10 runs" << endl;
             }
         }
 
         outfile << endl;
 
-        delete[] array;
+        freeArrayStorage(arrayMemory);
+        releaseMergeScratch(mergeScratch);
     }
 
     //Write final summary using stored averages in table format
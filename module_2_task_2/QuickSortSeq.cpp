@@ -6,6 +6,8 @@
 #include <iomanip>
 #include <fstream>
 #include <vector>
+#include "SortEngine.h"
+#include "SortVerify.h"
 
 using namespace std::chrono;
 using namespace std;
@@ -33,62 +35,36 @@ string formatWithCommas(long long number)
 }
 
 //Function to initialize array with random values
-void initializeArray(int array[], int size)
+void initializeArray(int array[], ptrdiff_t size)
 {
-    for (int i = 0; i < size; i++)
+    for (ptrdiff_t i = 0; i < size; i++)
     {
         array[i] = rand();
     }
 }
 
-//Function to perform partitioning
-int partition(int array[], int low, int high)
+//Sequential QuickSort function, backed by the introsort engine in SortEngine.h
+void quickSort(int array[], ptrdiff_t low, ptrdiff_t high)
 {
-    int pivot = array[high];
-    int i = (low - 1); 
-
-    for (int j = low; j <= high - 1; j++)
-    {
-        if (array[j] <= pivot)
-        {
-            i++; 
-            swap(array[i], array[j]);
-        }
-    }
-    swap(array[i + 1], array[high]);
-    return (i + 1);
+    introSort(array, low, high);
 }
 
-//Sequential QuickSort function
-void quickSort(int array[], int low, int high)
+//Main function that calls other functions
+int main(int argc, char* argv[])
 {
-    if (low < high)
-    {
-        int pivot = partition(array, low, high);
+    //Setup text output file and write heading
+    srand(time(0));
 
-        quickSort(array, low, pivot - 1);
-        quickSort(array, pivot + 1, high);
+    //Partition scheme can be chosen per run, "block" selects the branchless block partition
+    //and "simd" the AVX2 / AVX-512 partition and sorting networks
+    if (argc > 1 && string(argv[1]) == "block")
+    {
+        partitionScheme = PARTITION_BLOCK;
     }
-}
-
-//Function to verify if array is sorted (not timed)
-bool verifySorted(int array[], int size)
-{
-    for (int i = 0; i < size - 1; i++)
+    else if (argc > 1 && string(argv[1]) == "simd")
     {
-        if (array[i] > array[i + 1])
-        {
-            return false;
-        }
+        partitionScheme = PARTITION_SIMD;
     }
-    return true;
-}
-
-//Main function that calls other functions
-int main()
-{
-    //Setup text output file and write heading
-    srand(time(0));
 
     string filename = "QuickSortSeqResults.txt";
     ofstream outfile(filename);
@@ -100,11 +76,21 @@ int main()
 
     outfile << "---------------------------------------------" << endl;
     outfile << "Sequential QuickSort Results" << endl;
+    outfile << "Partition scheme: " << partitionSchemeName(partitionScheme) << endl;
+    if (partitionScheme == PARTITION_SIMD)
+    {
+        outfile << "SIMD instruction set: " << simdLevelName(activeSimdLevel()) << endl;
+    }
     outfile << "---------------------------------------------" << endl;
     
     outfile << endl;
 
     cout << "Starting Sequential QuickSort" << endl;
+    cout << "Partition scheme: " << partitionSchemeName(partitionScheme) << endl;
+    if (partitionScheme == PARTITION_SIMD)
+    {
+        cout << "SIMD instruction set: " << simdLevelName(activeSimdLevel()) << endl;
+    }
     cout << endl;
 
     //Stores average times for each array size to display them at end of file
@@ -127,10 +113,12 @@ int main()
         int* array = new int[size];
 
         long long durations[10];
+        int failedRuns = 0;
 
         for (int run = 0; run < 10; run++)
         {
             initializeArray(array, size);
+            unsigned long long inputHash = multisetHash(array, size);
 
             auto start = high_resolution_clock::now();
 
@@ -142,6 +130,9 @@ int main()
             durations[run] = duration.count();
 
             outfile << "Run " << (run + 1) << " - Time taken: " << formatWithCommas(durations[run]) << " microseconds" << endl;
+
+            //Verifies every run (not timed): in order, and no elements lost or duplicated
+            failedRuns += !verifySortedPermutation(array, size, inputHash);
         }
 
         //Calculates average
@@ -157,11 +148,10 @@ int main()
 
         sizeAverages.push_back(make_pair(size, avgLong));
 
-        //Verifies array is sorted correctly
-        if (!verifySorted(array, size))
+        if (failedRuns > 0)
         {
-            outfile << "Array was not sorted correctly" << endl;
-            cout << "Array size " << formatWithCommas(size) << " was not sorted correctly" << endl;
+            outfile << "Array was not sorted correctly in " << failedRuns << " of 10 runs" << endl;
+            cout << "Array size " << formatWithCommas(size) << " was not sorted correctly in " << failedRuns << " of 10 runs" << endl;
         }
 
         outfile << endl;
@@ -0,0 +1,300 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <omp.h>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include "SortEngine.h"
+
+//Parallel radix sorts for 32-bit integer keys.
+//Both variants work on 8-bit digits and need a scratch array the same size as the input.
+//LSD sorts the whole array one digit at a time from the lowest, MSD splits on the top digit and then recurses into each
+//bucket until it fits in cache, where the remaining digits are done LSD style.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+const int RADIX_BITS = 8;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+
+//Elements held per digit in a thread's write-combining buffer (16 ints = one 64 byte cache line)
+const int RADIX_WC_SIZE = 16;
+
+//MSD buckets at or below this many elements (1 MB of ints) are finished with LSD passes in cache
+const int RADIX_CACHE_ELEMENTS = 1 << 18;
+
+//Ranges at or below this size are finished with insertion sort
+const int RADIX_INSERTION_CUTOFF = 64;
+
+//DIGIT SECTION -----------------------------------------------------------------------------
+
+//Function to map an int to an unsigned key with the same order (flipping the sign bit puts negatives first)
+inline unsigned int radixKey(int value)
+{
+    return (unsigned int)value ^ 0x80000000u;
+}
+
+//Function to extract the digit at shift from a value
+inline int radixDigit(int value, int shift)
+{
+    return (int)((radixKey(value) >> shift) & (RADIX_BUCKETS - 1));
+}
+
+//SEQUENTIAL SECTION ------------------------------------------------------------------------
+
+//Function to sort data[0..n - 1] by the digits from 0 up to and including topShift, leaving the result in data
+//Passes where every element has the same digit are skipped.
+inline void lsdRadixSortSequential(int data[], int scratch[], std::ptrdiff_t n, int topShift)
+{
+    int *source = data;
+    int *destination = scratch;
+
+    for (int shift = 0; shift <= topShift; shift += RADIX_BITS)
+    {
+        std::ptrdiff_t counts[RADIX_BUCKETS] = {0};
+        for (std::ptrdiff_t i = 0; i < n; i++)
+        {
+            counts[radixDigit(source[i], shift)]++;
+        }
+        if (counts[radixDigit(source[0], shift)] == n)
+        {
+            continue;
+        }
+
+        std::ptrdiff_t offsets[RADIX_BUCKETS];
+        std::ptrdiff_t running = 0;
+        for (int d = 0; d < RADIX_BUCKETS; d++)
+        {
+            offsets[d] = running;
+            running += counts[d];
+        }
+        for (std::ptrdiff_t i = 0; i < n; i++)
+        {
+            destination[offsets[radixDigit(source[i], shift)]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != data)
+    {
+        memcpy(data, source, n * sizeof(int));
+    }
+}
+
+//Function to MSD radix sort data[0..n - 1] by the digits from shift downwards, leaving the result in data
+//Buckets recurse on the next digit until they fit in cache, then the remaining digits are sorted LSD style.
+inline void msdRadixSortSequential(int data[], int scratch[], std::ptrdiff_t n, int shift)
+{
+    if (n <= RADIX_INSERTION_CUTOFF)
+    {
+        insertionSort(data, 0, n - 1);
+        return;
+    }
+    if (n <= RADIX_CACHE_ELEMENTS || shift == 0)
+    {
+        lsdRadixSortSequential(data, scratch, n, shift);
+        return;
+    }
+
+    std::ptrdiff_t counts[RADIX_BUCKETS] = {0};
+    for (std::ptrdiff_t i = 0; i < n; i++)
+    {
+        counts[radixDigit(data[i], shift)]++;
+    }
+
+    std::ptrdiff_t starts[RADIX_BUCKETS + 1];
+    starts[0] = 0;
+    for (int d = 0; d < RADIX_BUCKETS; d++)
+    {
+        starts[d + 1] = starts[d] + counts[d];
+    }
+
+    if (counts[radixDigit(data[0], shift)] != n)
+    {
+        std::ptrdiff_t offsets[RADIX_BUCKETS];
+        memcpy(offsets, starts, sizeof(offsets));
+        for (std::ptrdiff_t i = 0; i < n; i++)
+        {
+            scratch[offsets[radixDigit(data[i], shift)]++] = data[i];
+        }
+        memcpy(data, scratch, n * sizeof(int));
+    }
+
+    for (int d = 0; d < RADIX_BUCKETS; d++)
+    {
+        if (counts[d] > 1)
+        {
+            msdRadixSortSequential(data + starts[d], scratch + starts[d], counts[d], shift - RADIX_BITS);
+        }
+    }
+}
+
+//PARALLEL SECTION --------------------------------------------------------------------------
+
+//Function to distribute source into destination by the digit at shift, called by every thread of the team together
+//1. Each thread builds a histogram of its contiguous chunk
+//2. Prefix sums over digits and then threads give every thread its own write position for each digit
+//3. Each thread scatters its chunk through write-combining buffers, so elements reach memory a cache line at a time
+//instead of one scattered store per element across 256 destinations.
+//Returns false (without moving anything) when every element has the same digit.
+inline bool radixScatterPass(const int source[], int destination[], std::ptrdiff_t n, int shift, std::vector<std::ptrdiff_t> &histograms, std::vector<std::ptrdiff_t> &bucketStarts)
+{
+    int tid = omp_get_thread_num();
+    int T = omp_get_num_threads();
+    std::ptrdiff_t chunk = (n + T - 1) / T;
+    std::ptrdiff_t start = std::min(n, tid * chunk);
+    std::ptrdiff_t end = std::min(n, (tid + 1) * chunk);
+
+    std::ptrdiff_t *histogram = &histograms[(size_t)tid * RADIX_BUCKETS];
+    for (int d = 0; d < RADIX_BUCKETS; d++)
+    {
+        histogram[d] = 0;
+    }
+    for (std::ptrdiff_t i = start; i < end; i++)
+    {
+        histogram[radixDigit(source[i], shift)]++;
+    }
+    #pragma omp barrier
+
+    #pragma omp single
+    {
+        std::ptrdiff_t running = 0;
+        for (int d = 0; d < RADIX_BUCKETS; d++)
+        {
+            bucketStarts[d] = running;
+            for (int t = 0; t < T; t++)
+            {
+                std::ptrdiff_t count = histograms[(size_t)t * RADIX_BUCKETS + d];
+                histograms[(size_t)t * RADIX_BUCKETS + d] = running;
+                running += count;
+            }
+        }
+        bucketStarts[RADIX_BUCKETS] = running;
+    }
+
+    //Every thread reads the same totals, so they all agree on skipping the pass
+    int firstDigit = radixDigit(source[0], shift);
+    if (bucketStarts[firstDigit + 1] - bucketStarts[firstDigit] == n)
+    {
+        #pragma omp barrier
+        return false;
+    }
+
+    alignas(64) int combine[RADIX_BUCKETS][RADIX_WC_SIZE];
+    int combineCount[RADIX_BUCKETS] = {0};
+    std::ptrdiff_t *position = histogram;
+
+    for (std::ptrdiff_t i = start; i < end; i++)
+    {
+        int value = source[i];
+        int digit = radixDigit(value, shift);
+        combine[digit][combineCount[digit]++] = value;
+        if (combineCount[digit] == RADIX_WC_SIZE)
+        {
+            memcpy(destination + position[digit], combine[digit], RADIX_WC_SIZE * sizeof(int));
+            position[digit] += RADIX_WC_SIZE;
+            combineCount[digit] = 0;
+        }
+    }
+    for (int d = 0; d < RADIX_BUCKETS; d++)
+    {
+        memcpy(destination + position[d], combine[d], combineCount[d] * sizeof(int));
+    }
+    #pragma omp barrier
+    return true;
+}
+
+//Function to LSD radix sort array[0..size - 1] in parallel, using omp_get_max_threads() threads
+inline void lsdRadixSort(int array[], std::ptrdiff_t size)
+{
+    if (size <= RADIX_INSERTION_CUTOFF)
+    {
+        insertionSort(array, 0, size - 1);
+        return;
+    }
+
+    int *scratch = new int[size];
+    int threads = omp_get_max_threads();
+    std::vector<std::ptrdiff_t> histograms((size_t)threads * RADIX_BUCKETS);
+    std::vector<std::ptrdiff_t> bucketStarts(RADIX_BUCKETS + 1);
+    int *result = array;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int *source = array;
+        int *destination = scratch;
+        for (int shift = 0; shift < 32; shift += RADIX_BITS)
+        {
+            if (radixScatterPass(source, destination, size, shift, histograms, bucketStarts))
+            {
+                std::swap(source, destination);
+            }
+        }
+        #pragma omp single
+        result = source;
+    }
+
+    if (result != array)
+    {
+        #pragma omp parallel for num_threads(threads)
+        for (std::ptrdiff_t i = 0; i < size; i++)
+        {
+            array[i] = result[i];
+        }
+    }
+    delete[] scratch;
+}
+
+//Function to MSD radix sort array[0..size - 1] in parallel, using omp_get_max_threads() threads
+//The top digit is distributed by the whole team, then the 256 buckets are shared out dynamically and each one is
+//sorted by a single thread, recursing on the next digit until the bucket fits in cache.
+inline void msdRadixSort(int array[], std::ptrdiff_t size)
+{
+    if (size <= RADIX_INSERTION_CUTOFF)
+    {
+        insertionSort(array, 0, size - 1);
+        return;
+    }
+
+    int *scratch = new int[size];
+    int threads = omp_get_max_threads();
+    std::vector<std::ptrdiff_t> histograms((size_t)threads * RADIX_BUCKETS);
+    std::vector<std::ptrdiff_t> bucketStarts(RADIX_BUCKETS + 1);
+    const int topShift = 32 - RADIX_BITS;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        //Find the highest digit that actually splits the keys (non-negative keys all share part of the top digit range,
+        //and equal keys share every digit), the team distributes on that digit
+        int shift = topShift;
+        bool moved = false;
+        while (!moved && shift >= 0)
+        {
+            moved = radixScatterPass(array, scratch, size, shift, histograms, bucketStarts);
+            if (!moved)
+            {
+                shift -= RADIX_BITS;
+            }
+        }
+
+        if (moved)
+        {
+            //Each bucket is copied back into its place in array and sorted there on the remaining digits
+            #pragma omp for schedule(dynamic, 1)
+            for (int d = 0; d < RADIX_BUCKETS; d++)
+            {
+                std::ptrdiff_t start = bucketStarts[d];
+                std::ptrdiff_t count = bucketStarts[d + 1] - start;
+                memcpy(array + start, scratch + start, count * sizeof(int));
+                if (count > 1 && shift > 0)
+                {
+                    msdRadixSortSequential(array + start, scratch + start, count, shift - RADIX_BITS);
+                }
+            }
+        }
+    }
+
+    delete[] scratch;
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include <iostream>
+#include <cstdlib>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <vector>
+#include "SortApi.h"
+
+using namespace std::chrono;
+using namespace std;
+
+//Function to format numbers with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    //Insert commas from right to left
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//RECORD SECTION ----------------------------------------------------------------------------
+
+//Record of Bytes bytes: a 64-bit key followed by a payload that has to travel with it
+template <int Bytes>
+struct record
+{
+    long long key;
+    char payload[Bytes - sizeof(long long)];
+};
+
+//An 8 byte record is just the key
+template <>
+struct record<8>
+{
+    long long key;
+};
+
+//Function to initialize records with random 64-bit keys
+template <int Bytes>
+void initializeRecords(record<Bytes> records[], int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        records[i].key = ((long long)rand() << 31) ^ rand();
+    }
+}
+
+//Function to check that records are in ascending key order
+template <int Bytes>
+bool isSortedByKey(const record<Bytes> records[], int size)
+{
+    for (int i = 0; i < size - 1; i++)
+    {
+        if (records[i].key > records[i + 1].key)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//BENCHMARK SECTION -------------------------------------------------------------------------
+
+//Function to benchmark the sort methods on one record size and write a table row per array size
+//1. Sort records: the records themselves are sorted by key, so every swap moves the whole payload
+//2. Argsort: only the permutation is computed (integer key fast path), the records are not touched
+//3. Argsort + gather: the permutation is applied afterwards, moving each record exactly once
+//4. Generic argsort + gather: the same with a custom comparator, which forces the indirect comparison path
+template <int Bytes>
+void benchmarkRecordSize(ofstream &outfile, const int testSizes[], int numSizes)
+{
+    auto keyOf = [](const record<Bytes> &r) { return r.key; };
+    auto customLess = [](long long a, long long b) { return a < b; };
+
+    for (int sizeIndex = 0; sizeIndex < numSizes; sizeIndex++)
+    {
+        int size = testSizes[sizeIndex];
+        cout << "Testing " << Bytes << " byte records, array size: " << formatWithCommas(size) << endl;
+
+        vector<record<Bytes>> original(size), array(size), output(size);
+        long long sortTime = 0, argsortTime = 0, gatherTime = 0, genericTime = 0;
+
+        for (int run = 0; run < 10; run++)
+        {
+            srand(run + 1);
+            initializeRecords(original.data(), size);
+
+            array = original;
+            auto start = high_resolution_clock::now();
+            sortByKey(array.data(), size, keyOf);
+            auto stop = high_resolution_clock::now();
+            sortTime += duration_cast<microseconds>(stop - start).count();
+            if (!isSortedByKey(array.data(), size))
+            {
+                cout << "Sort records did not sort " << Bytes << " byte records correctly" << endl;
+            }
+
+            start = high_resolution_clock::now();
+            vector<int> order = argsort(original.data(), size, keyOf);
+            stop = high_resolution_clock::now();
+            argsortTime += duration_cast<microseconds>(stop - start).count();
+
+            start = high_resolution_clock::now();
+            order = argsort(original.data(), size, keyOf);
+            applyPermutation(original.data(), order, output.data());
+            stop = high_resolution_clock::now();
+            gatherTime += duration_cast<microseconds>(stop - start).count();
+            if (!isSortedByKey(output.data(), size))
+            {
+                cout << "Argsort did not sort " << Bytes << " byte records correctly" << endl;
+            }
+
+            start = high_resolution_clock::now();
+            order = argsort(original.data(), size, keyOf, customLess);
+            applyPermutation(original.data(), order, output.data());
+            stop = high_resolution_clock::now();
+            genericTime += duration_cast<microseconds>(stop - start).count();
+            if (!isSortedByKey(output.data(), size))
+            {
+                cout << "Generic argsort did not sort " << Bytes << " byte records correctly" << endl;
+            }
+        }
+
+        outfile << "| " << Bytes << " | " << formatWithCommas(size)
+                << " | " << formatWithCommas(sortTime / 10) << " | " << formatWithCommas(argsortTime / 10)
+                << " | " << formatWithCommas(gatherTime / 10) << " | " << formatWithCommas(genericTime / 10) << " |" << endl;
+
+        cout << "  Sort records: " << formatWithCommas(sortTime / 10) << " us, Argsort: " << formatWithCommas(argsortTime / 10)
+             << " us, Argsort + gather: " << formatWithCommas(gatherTime / 10) << " us, Generic argsort + gather: "
+             << formatWithCommas(genericTime / 10) << " us" << endl;
+    }
+}
+
+//Main function that calls other functions
+int main()
+{
+    string filename = "RecordSortBenchmarkResults.txt";
+    ofstream outfile(filename);
+    if (!outfile.is_open())
+    {
+        cout << "Error: Could not create output file " << filename << endl;
+        return 1;
+    }
+
+    outfile << "---------------------------------------------" << endl;
+    outfile << "Record Sort Benchmark Results" << endl;
+    outfile << "---------------------------------------------" << endl;
+    outfile << endl;
+
+    cout << "Starting Record Sort Benchmark" << endl;
+    cout << endl;
+
+    int testSizes[] = {10000, 100000, 1000000};
+    int numSizes = sizeof(testSizes) / sizeof(testSizes[0]);
+
+    outfile << "| Record Size (bytes) | Array Size | Sort Records (us) | Argsort (us) | Argsort + Gather (us) | Generic Argsort + Gather (us) |" << endl;
+    outfile << "|---------------------|------------|-------------------|--------------|-----------------------|-------------------------------|" << endl;
+
+    benchmarkRecordSize<8>(outfile, testSizes, numSizes);
+    benchmarkRecordSize<16>(outfile, testSizes, numSizes);
+    benchmarkRecordSize<64>(outfile, testSizes, numSizes);
+    benchmarkRecordSize<128>(outfile, testSizes, numSizes);
+
+    outfile << endl;
+    outfile.close();
+    cout << "\nResults written to: " << filename << endl;
+
+    return 0;
+}
@@ -0,0 +1,554 @@
+#ifndef SAMPLE_SORT_H
+#define SAMPLE_SORT_H
+
+#include <omp.h>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include "SortEngine.h"
+
+//In-place parallel super scalar samplesort (IPS4o style).
+//Each level picks splitters from a sample, classifies every element into a bucket through a branchless splitter tree,
+//moves whole blocks of elements into their buckets in parallel, and then recurses into the buckets.
+//Apart from the input it only needs a fixed number of blocks per thread (independent of the array size).
+//Element positions, sizes and block slots are std::ptrdiff_t, only the keys themselves are int.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Number of elements in a block, the unit that classification buffers and the block permutation work in
+const int SAMPLE_SORT_BLOCK_SIZE = 256;
+
+//Largest splitter tree depth (2^7 = 128 buckets, doubled by the equality buckets)
+const int SAMPLE_SORT_MAX_LOG_BUCKETS = 7;
+const int SAMPLE_SORT_MAX_BUCKETS = 2 << SAMPLE_SORT_MAX_LOG_BUCKETS;
+
+//Ranges below this size are always left to the sequential engine
+const int SAMPLE_SORT_BASE_CASE = 65536;
+
+//STATE SECTION -----------------------------------------------------------------------------
+
+//Structure to hold everything the threads of one sort share
+//Per-thread storage is indexed by thread number, per-bucket storage by bucket number.
+struct sampleSortState
+{
+    int numThreads;
+
+    //Splitter tree (Eytzinger layout in tree[1..numTreeBuckets - 1]) and the sorted splitters used for equality checks
+    int logBuckets;
+    int numTreeBuckets;
+    int tree[1 << SAMPLE_SORT_MAX_LOG_BUCKETS];
+    int splitters[1 << SAMPLE_SORT_MAX_LOG_BUCKETS];
+
+    //Per-thread classification buffers, one partially filled block per bucket
+    std::vector<int> buffers;
+    std::vector<int> bufferCounts;
+    std::vector<std::ptrdiff_t> threadBucketSizes;
+    std::vector<int> swapBuffers;
+
+    //Per-thread stripe layout after classification, used to move full blocks in front of empty ones
+    std::vector<std::ptrdiff_t> stripeFullBlocks;
+    std::vector<std::ptrdiff_t> holeStart, holePrefix;
+    std::vector<std::ptrdiff_t> sourceStart, sourcePrefix;
+    std::ptrdiff_t numHoles;
+
+    //Per-bucket boundaries, block permutation pointers and locks
+    std::vector<std::ptrdiff_t> bucketStart;
+    std::vector<std::ptrdiff_t> writeBlock;
+    std::vector<std::ptrdiff_t> readBlock;
+    std::vector<omp_lock_t> locks;
+
+    //Elements of a bucket's last block that spill past the end of the bucket, and the block that spills past the array
+    std::vector<int> overhang;
+    std::vector<int> overhangCount;
+    std::vector<int> overflow;
+    std::ptrdiff_t overflowSlot;
+};
+
+//Function to size the shared state for a team of numThreads threads
+inline void initSampleSortState(sampleSortState &state, int numThreads)
+{
+    state.numThreads = numThreads;
+    state.buffers.assign((size_t)numThreads * SAMPLE_SORT_MAX_BUCKETS * SAMPLE_SORT_BLOCK_SIZE, 0);
+    state.bufferCounts.assign((size_t)numThreads * SAMPLE_SORT_MAX_BUCKETS, 0);
+    state.threadBucketSizes.assign((size_t)numThreads * SAMPLE_SORT_MAX_BUCKETS, 0);
+    state.swapBuffers.assign((size_t)numThreads * 2 * SAMPLE_SORT_BLOCK_SIZE, 0);
+    state.stripeFullBlocks.assign(numThreads, 0);
+    state.holeStart.assign(numThreads, 0);
+    state.holePrefix.assign(numThreads + 1, 0);
+    state.sourceStart.assign(numThreads, 0);
+    state.sourcePrefix.assign(numThreads + 1, 0);
+    state.bucketStart.assign(SAMPLE_SORT_MAX_BUCKETS + 1, 0);
+    state.writeBlock.assign(SAMPLE_SORT_MAX_BUCKETS, 0);
+    state.readBlock.assign(SAMPLE_SORT_MAX_BUCKETS, 0);
+    state.overhang.assign(SAMPLE_SORT_MAX_BUCKETS * SAMPLE_SORT_BLOCK_SIZE, 0);
+    state.overhangCount.assign(SAMPLE_SORT_MAX_BUCKETS, 0);
+    state.overflow.assign(SAMPLE_SORT_BLOCK_SIZE, 0);
+    state.locks.resize(SAMPLE_SORT_MAX_BUCKETS);
+    for (int b = 0; b < SAMPLE_SORT_MAX_BUCKETS; b++)
+    {
+        omp_init_lock(&state.locks[b]);
+    }
+}
+
+//Function to release the locks held by the state
+inline void destroySampleSortState(sampleSortState &state)
+{
+    for (int b = 0; b < SAMPLE_SORT_MAX_BUCKETS; b++)
+    {
+        omp_destroy_lock(&state.locks[b]);
+    }
+}
+
+//Function to return the smallest range a team of numThreads threads sorts cooperatively
+inline int sampleSortParallelCutoff(int numThreads)
+{
+    return std::max(SAMPLE_SORT_BASE_CASE, numThreads * SAMPLE_SORT_BLOCK_SIZE * 16);
+}
+
+//SPLITTER SECTION --------------------------------------------------------------------------
+
+//Function to fill the Eytzinger splitter tree with an in-order walk over the sorted splitters
+inline void fillSplitterTree(sampleSortState &state, int node, int &next)
+{
+    if (node >= state.numTreeBuckets)
+    {
+        return;
+    }
+    fillSplitterTree(state, 2 * node, next);
+    state.tree[node] = state.splitters[next++];
+    fillSplitterTree(state, 2 * node + 1, next);
+}
+
+//Function to draw a sample from data[0..n - 1], choose the splitters and build the splitter tree
+//Duplicate splitters are removed, and the tree shrinks to the smallest depth that still holds them.
+inline void buildSplitterTree(int data[], std::ptrdiff_t n, sampleSortState &state)
+{
+    const int B = SAMPLE_SORT_BLOCK_SIZE;
+
+    //Enough buckets that every thread still fills several blocks per bucket
+    int logBuckets = 1;
+    while (logBuckets < SAMPLE_SORT_MAX_LOG_BUCKETS && (long long)state.numThreads * (4 << logBuckets) * B * 4 <= n)
+    {
+        logBuckets++;
+    }
+    int numTreeBuckets = 1 << logBuckets;
+
+    //Oversampling factor of 0.2 * log2(n), as in IPS4o
+    int log2n = 0;
+    for (std::ptrdiff_t value = n; value > 1; value >>= 1)
+    {
+        log2n++;
+    }
+    int oversampling = std::max(1, log2n / 5);
+    int sampleSize = (int)std::min<std::ptrdiff_t>(n, oversampling * numTreeBuckets);
+
+    std::vector<int> sample(sampleSize);
+    uint64_t seed = 0x9E3779B97F4A7C15ULL ^ (uint64_t)n ^ (uint64_t)(uintptr_t)data;
+    for (int i = 0; i < sampleSize; i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        sample[i] = data[seed % (uint64_t)n];
+    }
+    introSort(sample.data(), 0, sampleSize - 1);
+
+    //Equidistant splitters from the sorted sample, without duplicates
+    int unique = 0;
+    for (int i = 1; i < numTreeBuckets; i++)
+    {
+        int splitter = sample[(long long)i * sampleSize / numTreeBuckets];
+        if (unique == 0 || state.splitters[unique - 1] != splitter)
+        {
+            state.splitters[unique++] = splitter;
+        }
+    }
+
+    while (logBuckets > 1 && (1 << (logBuckets - 1)) - 1 >= unique)
+    {
+        logBuckets--;
+    }
+    numTreeBuckets = 1 << logBuckets;
+
+    //Pad with the largest splitter, the last slot is only ever compared for equality when every splitter is smaller
+    for (int i = unique; i < numTreeBuckets; i++)
+    {
+        state.splitters[i] = state.splitters[unique - 1];
+    }
+
+    state.logBuckets = logBuckets;
+    state.numTreeBuckets = numTreeBuckets;
+    int next = 0;
+    fillSplitterTree(state, 1, next);
+}
+
+//Function to classify a value into its bucket without branching
+//The tree walk counts the splitters smaller than value, which picks bucket 2 * index. Values equal to the next splitter
+//go to the odd equality bucket 2 * index + 1 instead, which is never recursed into, so duplicate keys cannot stall the sort.
+inline int classifyElement(const sampleSortState &state, int value)
+{
+    int node = 1;
+    for (int level = 0; level < state.logBuckets; level++)
+    {
+        node = 2 * node + (state.tree[node] < value);
+    }
+    int index = node - state.numTreeBuckets;
+    return 2 * index + (value == state.splitters[index]);
+}
+
+//CLASSIFICATION SECTION --------------------------------------------------------------------
+
+//Function to classify one thread's stripe data[start..end - 1]
+//Elements are collected in the thread's per-bucket buffer, and every time a buffer fills up it is written back as a
+//full block at the front of the stripe. The write position never passes the read position, so this is done in place.
+inline void classifyStripe(int data[], std::ptrdiff_t start, std::ptrdiff_t end, sampleSortState &state, int tid)
+{
+    const int B = SAMPLE_SORT_BLOCK_SIZE;
+    int numBuckets = 2 * state.numTreeBuckets;
+    int *buffer = &state.buffers[(size_t)tid * SAMPLE_SORT_MAX_BUCKETS * B];
+    int *count = &state.bufferCounts[(size_t)tid * SAMPLE_SORT_MAX_BUCKETS];
+    std::ptrdiff_t *sizes = &state.threadBucketSizes[(size_t)tid * SAMPLE_SORT_MAX_BUCKETS];
+
+    for (int b = 0; b < numBuckets; b++)
+    {
+        count[b] = 0;
+        sizes[b] = 0;
+    }
+
+    std::ptrdiff_t write = start;
+    for (std::ptrdiff_t i = start; i < end; i++)
+    {
+        int value = data[i];
+        int bucket = classifyElement(state, value);
+        buffer[bucket * B + count[bucket]++] = value;
+        if (count[bucket] == B)
+        {
+            memcpy(data + write, buffer + bucket * B, B * sizeof(int));
+            write += B;
+            count[bucket] = 0;
+            sizes[bucket] += B;
+        }
+    }
+
+    for (int b = 0; b < numBuckets; b++)
+    {
+        sizes[b] += count[b];
+    }
+    state.stripeFullBlocks[tid] = (write - start) / B;
+}
+
+//Function to compute bucket boundaries and set up the block permutation (run by one thread)
+//Full blocks are first moved in front of all empty blocks (filling the holes left at the end of each stripe), so that
+//inside every bucket's block range the unprocessed blocks come first and the empty slots after them.
+inline void prepareBlockPermutation(std::ptrdiff_t n, sampleSortState &state)
+{
+    const int B = SAMPLE_SORT_BLOCK_SIZE;
+    int numBuckets = 2 * state.numTreeBuckets;
+    int T = state.numThreads;
+    std::ptrdiff_t numSlots = (n + B - 1) / B;
+    std::ptrdiff_t slotsPerStripe = (numSlots + T - 1) / T;
+
+    state.bucketStart[0] = 0;
+    for (int b = 0; b < numBuckets; b++)
+    {
+        std::ptrdiff_t total = 0;
+        for (int t = 0; t < T; t++)
+        {
+            total += state.threadBucketSizes[(size_t)t * SAMPLE_SORT_MAX_BUCKETS + b];
+        }
+        state.bucketStart[b + 1] = state.bucketStart[b] + total;
+    }
+
+    std::ptrdiff_t fullBlocks = 0;
+    for (int t = 0; t < T; t++)
+    {
+        fullBlocks += state.stripeFullBlocks[t];
+    }
+
+    state.holePrefix[0] = 0;
+    state.sourcePrefix[0] = 0;
+    for (int t = 0; t < T; t++)
+    {
+        std::ptrdiff_t stripeStart = std::min(numSlots, t * slotsPerStripe);
+        std::ptrdiff_t stripeEnd = std::min(numSlots, (t + 1) * slotsPerStripe);
+        std::ptrdiff_t fullEnd = stripeStart + state.stripeFullBlocks[t];
+
+        state.holeStart[t] = fullEnd;
+        state.holePrefix[t + 1] = state.holePrefix[t] + std::max<std::ptrdiff_t>(0, std::min(stripeEnd, fullBlocks) - fullEnd);
+
+        state.sourceStart[t] = std::max(stripeStart, fullBlocks);
+        state.sourcePrefix[t + 1] = state.sourcePrefix[t] + std::max<std::ptrdiff_t>(0, fullEnd - state.sourceStart[t]);
+    }
+    state.numHoles = state.holePrefix[T];
+
+    for (int b = 0; b < numBuckets; b++)
+    {
+        std::ptrdiff_t firstSlot = (state.bucketStart[b] + B - 1) / B;
+        std::ptrdiff_t lastSlot = (state.bucketStart[b + 1] + B - 1) / B;
+        state.writeBlock[b] = firstSlot;
+        state.readBlock[b] = std::max(firstSlot, std::min(lastSlot, fullBlocks));
+    }
+    state.overflowSlot = -1;
+}
+
+//Function to move the k-th full block found past the full prefix into the k-th hole inside it
+inline void fillHole(int data[], sampleSortState &state, std::ptrdiff_t k)
+{
+    const int B = SAMPLE_SORT_BLOCK_SIZE;
+    int T = state.numThreads;
+
+    int holeThread = (int)(std::upper_bound(state.holePrefix.begin(), state.holePrefix.begin() + T + 1, k) - state.holePrefix.begin()) - 1;
+    int sourceThread = (int)(std::upper_bound(state.sourcePrefix.begin(), state.sourcePrefix.begin() + T + 1, k) - state.sourcePrefix.begin()) - 1;
+
+    std::ptrdiff_t holeSlot = state.holeStart[holeThread] + (k - state.holePrefix[holeThread]);
+    std::ptrdiff_t sourceSlot = state.sourceStart[sourceThread] + (k - state.sourcePrefix[sourceThread]);
+
+    memcpy(data + (size_t)holeSlot * B, data + (size_t)sourceSlot * B, B * sizeof(int));
+}
+
+//BLOCK PERMUTATION SECTION -----------------------------------------------------------------
+
+//Function to move every full block into its bucket's block range (run by every thread)
+//Each bucket has a read pointer (unprocessed blocks are below it) and a write pointer (correctly placed blocks are below
+//it). A thread takes a block from the top of a bucket, writes it to the write pointer of the bucket it belongs to, and if
+//that slot still held an unprocessed block, carries that one on to its own bucket. Pointers and block copies for a bucket
+//are only touched under that bucket's lock, and threads start on different buckets to keep contention low.
+inline void permuteBlocks(int data[], std::ptrdiff_t n, sampleSortState &state, int tid)
+{
+    const int B = SAMPLE_SORT_BLOCK_SIZE;
+    int numBuckets = 2 * state.numTreeBuckets;
+    int *current = &state.swapBuffers[(size_t)tid * 2 * B];
+    int *next = current + B;
+    int startBucket = (int)((long long)tid * numBuckets / state.numThreads);
+
+    for (int step = 0; step < numBuckets; step++)
+    {
+        int bucket = (startBucket + step) % numBuckets;
+
+        while (true)
+        {
+            omp_set_lock(&state.locks[bucket]);
+            if (state.readBlock[bucket] <= state.writeBlock[bucket])
+            {
+                omp_unset_lock(&state.locks[bucket]);
+                break;
+            }
+            std::ptrdiff_t slot = --state.readBlock[bucket];
+            memcpy(current, data + (size_t)slot * B, B * sizeof(int));
+            omp_unset_lock(&state.locks[bucket]);
+
+            //Place the block, swapping out unprocessed blocks, until it lands in an empty slot
+            while (true)
+            {
+                int destination = classifyElement(state, current[0]);
+                omp_set_lock(&state.locks[destination]);
+                std::ptrdiff_t target = state.writeBlock[destination]++;
+                bool occupied = target < state.readBlock[destination];
+                if (occupied)
+                {
+                    memcpy(next, data + (size_t)target * B, B * sizeof(int));
+                }
+                if ((target + 1) * B > n)
+                {
+                    //The last slot of the last bucket can run past the end of the array
+                    memcpy(state.overflow.data(), current, B * sizeof(int));
+                    state.overflowSlot = target;
+                }
+                else
+                {
+                    memcpy(data + (size_t)target * B, current, B * sizeof(int));
+                }
+                omp_unset_lock(&state.locks[destination]);
+
+                if (!occupied)
+                {
+                    break;
+                }
+                std::swap(current, next);
+            }
+        }
+    }
+}
+
+//CLEANUP SECTION ---------------------------------------------------------------------------
+
+//Function to save the part of a bucket's last block that spills past the bucket's end
+//Blocks start at the first block boundary inside the bucket, so the last one can run into the next bucket's head.
+//This runs for every bucket before any gaps are filled, because the spilled elements sit where the next bucket writes.
+inline void saveOverhang(int data[], std::ptrdiff_t n, sampleSortState &state, int bucket)
+{
+    const int B = SAMPLE_SORT_BLOCK_SIZE;
+    std::ptrdiff_t end = state.bucketStart[bucket + 1];
+    std::ptrdiff_t writtenEnd = state.writeBlock[bucket] * B;
+    std::ptrdiff_t overflowStart = (state.overflowSlot >= 0) ? state.overflowSlot * B : n + B;
+    bool ownsOverflow = state.overflowSlot >= 0 && state.writeBlock[bucket] == state.overflowSlot + 1
+                        && (state.bucketStart[bucket] + B - 1) / B <= state.overflowSlot;
+
+    //A bucket with no full blocks has writtenEnd at its first block boundary, which can lie past its end without spilling
+    std::ptrdiff_t aligned = (state.bucketStart[bucket] + B - 1) / B * B;
+    int count = 0;
+    for (std::ptrdiff_t pos = std::max(end, aligned); pos < writtenEnd; pos++)
+    {
+        state.overhang[bucket * B + count++] = (ownsOverflow && pos >= overflowStart) ? state.overflow[pos - overflowStart] : data[pos];
+    }
+    state.overhangCount[bucket] = count;
+
+    if (ownsOverflow)
+    {
+        for (std::ptrdiff_t pos = overflowStart; pos < std::min(end, n); pos++)
+        {
+            data[pos] = state.overflow[pos - overflowStart];
+        }
+    }
+}
+
+//Function to fill the head and tail gaps of a bucket from its saved overhang and the threads' partial buffers
+inline void fillBucketGaps(int data[], sampleSortState &state, int bucket)
+{
+    const int B = SAMPLE_SORT_BLOCK_SIZE;
+    std::ptrdiff_t start = state.bucketStart[bucket];
+    std::ptrdiff_t end = state.bucketStart[bucket + 1];
+    std::ptrdiff_t aligned = (start + B - 1) / B * B;
+    std::ptrdiff_t writtenEnd = state.writeBlock[bucket] * B;
+
+    std::ptrdiff_t headEnd = std::min(aligned, end);
+    std::ptrdiff_t tailStart = std::max(headEnd, std::min(writtenEnd, end));
+
+    std::ptrdiff_t pos = start;
+    auto put = [&](int value)
+    {
+        if (pos == headEnd)
+        {
+            pos = tailStart;
+        }
+        data[pos++] = value;
+    };
+
+    for (int i = 0; i < state.overhangCount[bucket]; i++)
+    {
+        put(state.overhang[bucket * B + i]);
+    }
+    for (int t = 0; t < state.numThreads; t++)
+    {
+        int *buffer = &state.buffers[((size_t)t * SAMPLE_SORT_MAX_BUCKETS + bucket) * B];
+        int count = state.bufferCounts[(size_t)t * SAMPLE_SORT_MAX_BUCKETS + bucket];
+        for (int i = 0; i < count; i++)
+        {
+            put(buffer[i]);
+        }
+    }
+}
+
+//SAMPLESORT SECTION ------------------------------------------------------------------------
+
+//Function to partition data[0..n - 1] into buckets and sort them, called by every thread of the team together
+//Buckets that are still large are sorted by the whole team one after another, the rest are shared out between the
+//threads and finished by the sequential engine. Equality buckets only hold copies of one key and are already sorted.
+inline void sampleSortStep(int data[], std::ptrdiff_t n, sampleSortState &state)
+{
+    const int B = SAMPLE_SORT_BLOCK_SIZE;
+    int tid = omp_get_thread_num();
+    int T = state.numThreads;
+
+    //1. Sampling and splitter tree
+    #pragma omp single
+    buildSplitterTree(data, n, state);
+
+    //2. Local classification of each thread's stripe
+    std::ptrdiff_t numSlots = (n + B - 1) / B;
+    std::ptrdiff_t slotsPerStripe = (numSlots + T - 1) / T;
+    std::ptrdiff_t stripeStart = std::min(n, tid * slotsPerStripe * B);
+    std::ptrdiff_t stripeEnd = std::min(n, (tid + 1) * slotsPerStripe * B);
+    classifyStripe(data, stripeStart, stripeEnd, state, tid);
+    #pragma omp barrier
+
+    //3. Bucket boundaries, then gather the full blocks in front of the empty ones
+    #pragma omp single
+    prepareBlockPermutation(n, state);
+
+    #pragma omp for schedule(static)
+    for (std::ptrdiff_t k = 0; k < state.numHoles; k++)
+    {
+        fillHole(data, state, k);
+    }
+
+    //4. Parallel block permutation
+    permuteBlocks(data, n, state, tid);
+    #pragma omp barrier
+
+    //5. Cleanup of the partial blocks at bucket boundaries
+    int numBuckets = 2 * state.numTreeBuckets;
+
+    #pragma omp for schedule(static)
+    for (int b = 0; b < numBuckets; b++)
+    {
+        saveOverhang(data, n, state, b);
+    }
+
+    #pragma omp for schedule(dynamic, 1)
+    for (int b = 0; b < numBuckets; b++)
+    {
+        fillBucketGaps(data, state, b);
+    }
+
+    //6. Recursion, each thread keeps its own copy of the boundaries since the next level reuses the shared state
+    std::vector<std::ptrdiff_t> bucketStart(state.bucketStart.begin(), state.bucketStart.begin() + numBuckets + 1);
+    int parallelCutoff = sampleSortParallelCutoff(T);
+    #pragma omp barrier
+
+    for (int b = 0; b < numBuckets; b += 2)
+    {
+        std::ptrdiff_t size = bucketStart[b + 1] - bucketStart[b];
+        if (size >= parallelCutoff && size < n)
+        {
+            sampleSortStep(data + bucketStart[b], size, state);
+        }
+    }
+
+    #pragma omp for schedule(dynamic, 1)
+    for (int b = 0; b < numBuckets; b += 2)
+    {
+        std::ptrdiff_t size = bucketStart[b + 1] - bucketStart[b];
+        if (size > 1 && (size < parallelCutoff || size == n))
+        {
+            introSort(data + bucketStart[b], 0, size - 1);
+        }
+    }
+}
+
+//Function to sort array[0..size - 1] with the parallel samplesort, using omp_get_max_threads() threads
+//Must be called from outside a parallel region.
+inline void sampleSort(int array[], std::ptrdiff_t size)
+{
+    int threads = omp_get_max_threads();
+    if (size < sampleSortParallelCutoff(1))
+    {
+        introSort(array, 0, size - 1);
+        return;
+    }
+
+    sampleSortState state;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        //The runtime can hand out fewer threads than requested, so the state is sized for the real team
+        #pragma omp single
+        initSampleSortState(state, omp_get_num_threads());
+
+        if (size >= sampleSortParallelCutoff(state.numThreads))
+        {
+            sampleSortStep(array, size, state);
+        }
+        else
+        {
+            #pragma omp single
+            introSort(array, 0, size - 1);
+        }
+    }
+
+    destroySampleSortState(state);
+}
+
+#endif
@@ -0,0 +1,264 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <omp.h>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include "SortEngine.h"
+#include "ParallelPartition.h"
+#include "SampleSort.h"
+
+//Selection without a full sort: the k-th smallest element (nth_element), the smallest k in order (partial sort) and
+//several ranks or quantiles at once.
+//All of them reuse the engine's pivot selection and partitioning but only follow the side (or sides) of each partition
+//that still contain a wanted rank, so a single rank costs O(n) on average instead of O(n log n).
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Ranges above this size with wanted ranks on both sides of a split hand one side out as a task
+const int SELECT_TASK_CUTOFF = 65536;
+
+//SEQUENTIAL SECTION ------------------------------------------------------------------------
+
+//Function to rearrange array[low..high] so array[k] holds the element that would be there if the range were sorted,
+//with nothing greater before it and nothing smaller after it (introselect)
+//Each partition discards the side without k, and once the depth limit runs out the rest is heapsorted so the worst
+//case stays O(n log n).
+template <typename T, typename Less = std::less<T>>
+inline void introSelect(T array[], std::ptrdiff_t low, std::ptrdiff_t high, std::ptrdiff_t k, int depthLimit, Less less = Less())
+{
+    while (high - low + 1 > INSERTION_SORT_CUTOFF)
+    {
+        if (depthLimit == 0)
+        {
+            heapSort(array, low, high, less);
+            return;
+        }
+        depthLimit--;
+
+        std::ptrdiff_t lessEnd, greaterStart;
+        partitionRange(array, low, high, lessEnd, greaterStart, less);
+
+        if (k < lessEnd)
+        {
+            high = lessEnd - 1;
+        }
+        else if (k > greaterStart)
+        {
+            low = greaterStart + 1;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    insertionSort(array, low, high, less);
+}
+
+//Function to rearrange array[low..high] so every rank in ranks[0..numRanks - 1] (sorted, inside the range) holds
+//the element it would hold if the range were sorted
+//The ranks are split at each partition and only the sides that still have ranks are followed.
+template <typename T, typename Less = std::less<T>>
+inline void multiSelectSequential(T array[], std::ptrdiff_t low, std::ptrdiff_t high, const std::ptrdiff_t ranks[], int numRanks, int depthLimit, Less less = Less())
+{
+    while (numRanks > 0)
+    {
+        if (numRanks == 1)
+        {
+            introSelect(array, low, high, ranks[0], depthLimit, less);
+            return;
+        }
+        if (high - low + 1 <= INSERTION_SORT_CUTOFF || depthLimit == 0)
+        {
+            introSort(array, low, high, depthLimit, less);
+            return;
+        }
+        depthLimit--;
+
+        std::ptrdiff_t lessEnd, greaterStart;
+        partitionRange(array, low, high, lessEnd, greaterStart, less);
+
+        int leftRanks = (int)(std::lower_bound(ranks, ranks + numRanks, lessEnd) - ranks);
+        int rightStart = (int)(std::upper_bound(ranks, ranks + numRanks, greaterStart) - ranks);
+
+        multiSelectSequential(array, low, lessEnd - 1, ranks, leftRanks, depthLimit, less);
+        low = greaterStart + 1;
+        ranks += rightStart;
+        numRanks -= rightStart;
+    }
+}
+
+//PARALLEL SECTION --------------------------------------------------------------------------
+
+//Function to select rank k in array[low..high], called by a single thread inside a parallel region
+//Ranges above PARALLEL_PARTITION_CUTOFF are partitioned by the whole team with scratch, the rest is introselect.
+inline void selectRange(int array[], int scratch[], std::ptrdiff_t low, std::ptrdiff_t high, std::ptrdiff_t k, int depthLimit)
+{
+    while (scratch != NULL && high - low + 1 > PARALLEL_PARTITION_CUTOFF && depthLimit > 0)
+    {
+        depthLimit--;
+        std::ptrdiff_t lessEnd, greaterStart;
+        parallelPartition(array, scratch, low, high, selectPivot(array, low, high), lessEnd, greaterStart);
+
+        if (k < lessEnd)
+        {
+            high = lessEnd - 1;
+        }
+        else if (k > greaterStart)
+        {
+            low = greaterStart + 1;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    introSelect(array, low, high, k, depthLimit);
+}
+
+//Function to select every rank in ranks[0..numRanks - 1] in array[low..high], called by a single thread inside a
+//parallel region
+//Large ranges are partitioned by the whole team, and when both sides of a split still have ranks the left side is
+//handed out as a task while this thread carries on with the right.
+inline void multiSelectRange(int array[], int scratch[], std::ptrdiff_t low, std::ptrdiff_t high, const std::ptrdiff_t ranks[], int numRanks, int depthLimit)
+{
+    while (numRanks > 0)
+    {
+        std::ptrdiff_t count = high - low + 1;
+        if (count <= SELECT_TASK_CUTOFF || depthLimit == 0)
+        {
+            multiSelectSequential(array, low, high, ranks, numRanks, depthLimit);
+            return;
+        }
+        depthLimit--;
+
+        std::ptrdiff_t lessEnd, greaterStart;
+        if (scratch != NULL && count > PARALLEL_PARTITION_CUTOFF)
+        {
+            parallelPartition(array, scratch, low, high, selectPivot(array, low, high), lessEnd, greaterStart);
+        }
+        else
+        {
+            partitionRange(array, low, high, lessEnd, greaterStart);
+        }
+
+        int leftRanks = (int)(std::lower_bound(ranks, ranks + numRanks, lessEnd) - ranks);
+        int rightStart = (int)(std::upper_bound(ranks, ranks + numRanks, greaterStart) - ranks);
+
+        if (leftRanks > 0)
+        {
+            #pragma omp task firstprivate(low, lessEnd, ranks, leftRanks, depthLimit)
+            multiSelectRange(array, scratch, low, lessEnd - 1, ranks, leftRanks, depthLimit);
+        }
+
+        low = greaterStart + 1;
+        ranks += rightStart;
+        numRanks -= rightStart;
+    }
+}
+
+//Function to allocate the scratch buffer for the parallel partition when the array is large enough to use it
+inline int* allocateSelectScratch(std::ptrdiff_t size)
+{
+    if (size > PARALLEL_PARTITION_CUTOFF && omp_get_max_threads() > 1)
+    {
+        return new int[size];
+    }
+    return NULL;
+}
+
+//Function to rearrange array[0..size - 1] so array[k] holds the k-th smallest element (0 based), with nothing greater
+//before it and nothing smaller after it, returns that element
+//For the k largest elements select size - k: they end up in array[size - k..size - 1].
+//k outside [0, size - 1] is clamped to that range, and an empty array returns 0 without touching it.
+inline int parallelSelect(int array[], std::ptrdiff_t size, std::ptrdiff_t k)
+{
+    if (size <= 0)
+    {
+        return 0;
+    }
+    k = std::min(std::max<std::ptrdiff_t>(k, 0), size - 1);
+
+    int *scratch = allocateSelectScratch(size);
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        selectRange(array, scratch, 0, size - 1, k, introSortDepthLimit(size));
+    }
+
+    delete[] scratch;
+    return array[k];
+}
+
+//Function to put the k smallest elements of array[0..size - 1] in sorted order at the front, leaving the rest in
+//any order behind them
+//The k-th smallest is selected first, then only array[0..k - 1] is sorted with the parallel samplesort.
+inline void parallelPartialSort(int array[], std::ptrdiff_t size, std::ptrdiff_t k)
+{
+    if (k <= 0)
+    {
+        return;
+    }
+    if (k < size)
+    {
+        parallelSelect(array, size, k - 1);
+    }
+    sampleSort(array, std::min(k, size));
+}
+
+//Function to rearrange array[0..size - 1] so every rank in ranks holds the element it would hold if sorted
+//Returns those elements in the same order as ranks (nothing for an empty array).
+inline std::vector<int> parallelMultiSelect(int array[], std::ptrdiff_t size, std::vector<std::ptrdiff_t> ranks)
+{
+    if (size <= 0)
+    {
+        return std::vector<int>();
+    }
+
+    std::vector<std::ptrdiff_t> wanted(ranks);
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+
+    int *scratch = allocateSelectScratch(size);
+    const std::ptrdiff_t *rankList = ranks.data();
+    int numRanks = (int)ranks.size();
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            //The taskgroup waits for every side handed out as a task below
+            #pragma omp taskgroup
+            multiSelectRange(array, scratch, 0, size - 1, rankList, numRanks, introSortDepthLimit(size));
+        }
+    }
+
+    delete[] scratch;
+
+    std::vector<int> values(wanted.size());
+    for (size_t i = 0; i < wanted.size(); i++)
+    {
+        values[i] = array[wanted[i]];
+    }
+    return values;
+}
+
+//Function to return the given quantiles (0.0 to 1.0) of array[0..size - 1], rearranging it like parallelMultiSelect
+//Quantile q is the element at rank floor(q * (size - 1)) of the sorted array.
+inline std::vector<int> parallelQuantiles(int array[], std::ptrdiff_t size, const std::vector<double> &quantiles)
+{
+    std::vector<std::ptrdiff_t> ranks(quantiles.size());
+    for (size_t i = 0; i < quantiles.size(); i++)
+    {
+        double q = std::min(1.0, std::max(0.0, quantiles[i]));
+        ranks[i] = (std::ptrdiff_t)(q * (size - 1));
+    }
+    return parallelMultiSelect(array, size, ranks);
+}
+
+#endif
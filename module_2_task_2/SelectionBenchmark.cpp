@@ -0,0 +1,171 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <omp.h>
+#include "Selection.h"
+
+using namespace std::chrono;
+using namespace std;
+
+//Function to format numbers with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    //Insert commas from right to left
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Function to initialize array with random values
+void initializeArray(int array[], int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        array[i] = rand();
+    }
+}
+
+//Main function that calls other functions
+//Each selection is timed against sorting the whole array with the parallel samplesort, which is what finding the
+//same answer by a full sort costs. Every run checks the answer against that sorted array.
+int main()
+{
+    string filename = "SelectionBenchmarkResults.txt";
+    ofstream outfile(filename);
+    if (!outfile.is_open())
+    {
+        cout << "Error: Could not create output file " << filename << endl;
+        return 1;
+    }
+
+    outfile << "---------------------------------------------" << endl;
+    outfile << "Selection Benchmark Results" << endl;
+    outfile << "Threads: " << omp_get_max_threads() << endl;
+    outfile << "---------------------------------------------" << endl;
+    outfile << endl;
+
+    cout << "Starting Selection Benchmark" << endl;
+    cout << "Threads: " << omp_get_max_threads() << endl;
+    cout << endl;
+
+    int testSizes[] = {1000000, 10000000};
+    int numSizes = sizeof(testSizes) / sizeof(testSizes[0]);
+
+    outfile << "| Array Size | Query | Selection (us) | Full Sort (us) | Speedup |" << endl;
+    outfile << "|------------|-------|----------------|----------------|---------|" << endl;
+
+    for (int sizeIndex = 0; sizeIndex < numSizes; sizeIndex++)
+    {
+        int size = testSizes[sizeIndex];
+        cout << "Testing array size: " << formatWithCommas(size) << endl;
+
+        int* original = new int[size];
+        int* sorted = new int[size];
+        int* array = new int[size];
+
+        int kValues[] = {10, 1000, size / 100};
+        vector<double> quantiles = {0.5, 0.9, 0.99, 0.999};
+
+        //Queries: nth_element and partial sort for each k, then one multi-quantile query
+        vector<string> queryNames;
+        for (int k : kValues)
+        {
+            queryNames.push_back("nth_element k = " + formatWithCommas(k));
+            queryNames.push_back("partial_sort k = " + formatWithCommas(k));
+        }
+        queryNames.push_back("quantiles 50/90/99/99.9%");
+        int numQueries = (int)queryNames.size();
+
+        vector<long long> selectTime(numQueries, 0);
+        long long sortTime = 0;
+
+        for (int run = 0; run < 10; run++)
+        {
+            srand(run + 1);
+            initializeArray(original, size);
+
+            memcpy(sorted, original, size * sizeof(int));
+            auto start = high_resolution_clock::now();
+            sampleSort(sorted, size);
+            auto stop = high_resolution_clock::now();
+            sortTime += duration_cast<microseconds>(stop - start).count();
+
+            int query = 0;
+            for (int k : kValues)
+            {
+                memcpy(array, original, size * sizeof(int));
+                start = high_resolution_clock::now();
+                int value = parallelSelect(array, size, k - 1);
+                stop = high_resolution_clock::now();
+                selectTime[query++] += duration_cast<microseconds>(stop - start).count();
+                if (value != sorted[k - 1])
+                {
+                    cout << "nth_element returned the wrong element for k = " << k << endl;
+                }
+
+                memcpy(array, original, size * sizeof(int));
+                start = high_resolution_clock::now();
+                parallelPartialSort(array, size, k);
+                stop = high_resolution_clock::now();
+                selectTime[query++] += duration_cast<microseconds>(stop - start).count();
+                if (memcmp(array, sorted, k * sizeof(int)) != 0)
+                {
+                    cout << "partial_sort did not sort the smallest " << k << " elements correctly" << endl;
+                }
+            }
+
+            memcpy(array, original, size * sizeof(int));
+            start = high_resolution_clock::now();
+            vector<int> values = parallelQuantiles(array, size, quantiles);
+            stop = high_resolution_clock::now();
+            selectTime[query++] += duration_cast<microseconds>(stop - start).count();
+            for (size_t q = 0; q < quantiles.size(); q++)
+            {
+                if (values[q] != sorted[(int)(quantiles[q] * (size - 1))])
+                {
+                    cout << "Quantile " << quantiles[q] << " was wrong" << endl;
+                }
+            }
+        }
+
+        long long sortAverage = sortTime / 10;
+        for (int query = 0; query < numQueries; query++)
+        {
+            long long average = selectTime[query] / 10;
+            double speedup = (average > 0) ? (double)sortAverage / average : 0.0;
+            outfile << "| " << formatWithCommas(size) << " | " << queryNames[query] << " | " << formatWithCommas(average)
+                    << " | " << formatWithCommas(sortAverage) << " | " << fixed << setprecision(1) << speedup << "x |" << endl;
+            cout << "  " << queryNames[query] << ": " << formatWithCommas(average) << " us (full sort "
+                 << formatWithCommas(sortAverage) << " us, " << fixed << setprecision(1) << speedup << "x)" << endl;
+        }
+
+        delete[] original;
+        delete[] sorted;
+        delete[] array;
+    }
+
+    outfile << endl;
+    outfile.close();
+    cout << "\nResults written to: " << filename << endl;
+
+    return 0;
+}
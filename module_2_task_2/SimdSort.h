@@ -0,0 +1,384 @@
+#ifndef SIMD_SORT_H
+#define SIMD_SORT_H
+
+#include <climits>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_SORT_X86 1
+#endif
+
+//AVX2 and AVX-512 kernels for the sort engine: bitonic sorting networks for small blocks and a vectorised partition.
+//Each kernel is compiled for its instruction set with a target attribute and picked at runtime, so the programs still
+//build without any -m flags and run on machines without the instructions (the engine then uses its scalar code).
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Largest block the sorting networks handle (padded up to a power of two)
+const int SIMD_NETWORK_MAX = 256;
+
+//Instruction sets the kernels can use
+enum SimdLevel
+{
+    SIMD_SCALAR,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+//Highest instruction set the kernels are allowed to use, lowered by benchmarks to compare the kernels
+inline SimdLevel simdLevelLimit = SIMD_AVX512;
+
+//DISPATCH SECTION --------------------------------------------------------------------------
+
+//Function to detect the best instruction set the CPU supports (checked once)
+inline SimdLevel detectSimdLevel()
+{
+#ifdef SIMD_SORT_X86
+    static const SimdLevel level = __builtin_cpu_supports("avx512f") ? SIMD_AVX512 : (__builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SCALAR);
+    return level;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+//Function to return the instruction set the kernels will use
+inline SimdLevel activeSimdLevel()
+{
+    SimdLevel detected = detectSimdLevel();
+    return (detected < simdLevelLimit) ? detected : simdLevelLimit;
+}
+
+//Function to return the display name of an instruction set
+inline const char* simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+        case SIMD_AVX512:
+            return "AVX-512";
+        case SIMD_AVX2:
+            return "AVX2";
+        default:
+            return "Scalar";
+    }
+}
+
+#ifdef SIMD_SORT_X86
+
+//BITONIC NETWORK SECTION -------------------------------------------------------------------
+
+//GCC 12 reports the placeholder source inside its own AVX-512 min/max/permute intrinsics as maybe uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+//Bitonic sort of buf[0..size - 1] with AVX-512 (size is a power of two from 16 to SIMD_NETWORK_MAX)
+//Compare distances of a vector or more pair up whole vectors, shorter ones pair lanes inside a vector through a permute.
+//A lane keeps the larger value when it is the upper half of its pair XOR its run is sorted descending.
+__attribute__((target("avx512f")))
+inline void bitonicSortAvx512(int buf[], int size)
+{
+    const __m512i iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    for (int k = 2; k <= size; k <<= 1)
+    {
+        for (int j = k >> 1; j > 0; j >>= 1)
+        {
+            if (j >= 16)
+            {
+                for (int i = 0; i < size; i += 16)
+                {
+                    if (i & j) continue;
+                    __m512i a = _mm512_load_si512((const void*)(buf + i));
+                    __m512i b = _mm512_load_si512((const void*)(buf + i + j));
+                    __m512i low = _mm512_min_epi32(a, b);
+                    __m512i high = _mm512_max_epi32(a, b);
+                    bool descending = (i & k) != 0;
+                    _mm512_store_si512((void*)(buf + i), descending ? high : low);
+                    _mm512_store_si512((void*)(buf + i + j), descending ? low : high);
+                }
+            }
+            else
+            {
+                const __m512i partner = _mm512_xor_si512(iota, _mm512_set1_epi32(j));
+                for (int i = 0; i < size; i += 16)
+                {
+                    __m512i a = _mm512_load_si512((const void*)(buf + i));
+                    __m512i b = _mm512_permutexvar_epi32(partner, a);
+                    __m512i low = _mm512_min_epi32(a, b);
+                    __m512i high = _mm512_max_epi32(a, b);
+                    __m512i index = _mm512_add_epi32(iota, _mm512_set1_epi32(i));
+                    __mmask16 upper = _mm512_test_epi32_mask(index, _mm512_set1_epi32(j));
+                    __mmask16 descending = _mm512_test_epi32_mask(index, _mm512_set1_epi32(k));
+                    _mm512_store_si512((void*)(buf + i), _mm512_mask_blend_epi32(upper ^ descending, low, high));
+                }
+            }
+        }
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+//Bitonic sort of buf[0..size - 1] with AVX2 (size is a power of two from 8 to SIMD_NETWORK_MAX)
+__attribute__((target("avx2")))
+inline void bitonicSortAvx2(int buf[], int size)
+{
+    const __m256i iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (int k = 2; k <= size; k <<= 1)
+    {
+        for (int j = k >> 1; j > 0; j >>= 1)
+        {
+            if (j >= 8)
+            {
+                for (int i = 0; i < size; i += 8)
+                {
+                    if (i & j) continue;
+                    __m256i a = _mm256_load_si256((const __m256i*)(buf + i));
+                    __m256i b = _mm256_load_si256((const __m256i*)(buf + i + j));
+                    __m256i low = _mm256_min_epi32(a, b);
+                    __m256i high = _mm256_max_epi32(a, b);
+                    bool descending = (i & k) != 0;
+                    _mm256_store_si256((__m256i*)(buf + i), descending ? high : low);
+                    _mm256_store_si256((__m256i*)(buf + i + j), descending ? low : high);
+                }
+            }
+            else
+            {
+                const __m256i partner = _mm256_xor_si256(iota, _mm256_set1_epi32(j));
+                for (int i = 0; i < size; i += 8)
+                {
+                    __m256i a = _mm256_load_si256((const __m256i*)(buf + i));
+                    __m256i b = _mm256_permutevar8x32_epi32(a, partner);
+                    __m256i low = _mm256_min_epi32(a, b);
+                    __m256i high = _mm256_max_epi32(a, b);
+                    __m256i index = _mm256_add_epi32(iota, _mm256_set1_epi32(i));
+                    __m256i lower = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(j)), zero);
+                    __m256i ascending = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(k)), zero);
+                    __m256i takeHigh = _mm256_xor_si256(lower, ascending);
+                    _mm256_store_si256((__m256i*)(buf + i), _mm256_blendv_epi8(low, high, takeHigh));
+                }
+            }
+        }
+    }
+}
+
+//VECTORISED PARTITION SECTION --------------------------------------------------------------
+
+//Function to finish a vectorised partition: the two vectors saved at the start and the last few unread elements are
+//written into the gap between the left and right write positions, which they fill exactly. Returns the boundary.
+inline std::ptrdiff_t finishSimdPartition(int array[], int rest[], int count, std::ptrdiff_t writeLeft, std::ptrdiff_t writeRight, int pivot)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (rest[i] < pivot)
+        {
+            array[writeLeft++] = rest[i];
+        }
+        else
+        {
+            array[--writeRight] = rest[i];
+        }
+    }
+    return writeLeft;
+}
+
+//Function to partition array[first..last - 1] so elements < pivot come first with AVX-512, returns the boundary
+//One vector from each end is saved first, which leaves a vector's worth of free space on both sides. Every step then
+//reads a vector from whichever side has less free space and compress-stores its elements < pivot to the left write
+//position and the rest to the right one, so writes can never overtake unread data.
+__attribute__((target("avx512f,popcnt")))
+inline std::ptrdiff_t simdPartitionAvx512(int array[], std::ptrdiff_t first, std::ptrdiff_t last, int pivot)
+{
+    const int W = 16;
+    const __m512i pivotVector = _mm512_set1_epi32(pivot);
+
+    __m512i savedLeft = _mm512_loadu_si512((const void*)(array + first));
+    __m512i savedRight = _mm512_loadu_si512((const void*)(array + last - W));
+    std::ptrdiff_t readLeft = first + W, readRight = last - W;
+    std::ptrdiff_t writeLeft = first, writeRight = last;
+
+    while (readRight - readLeft >= W)
+    {
+        __m512i values;
+        if (readLeft - writeLeft <= writeRight - readRight)
+        {
+            values = _mm512_loadu_si512((const void*)(array + readLeft));
+            readLeft += W;
+        }
+        else
+        {
+            readRight -= W;
+            values = _mm512_loadu_si512((const void*)(array + readRight));
+        }
+
+        __mmask16 less = _mm512_cmplt_epi32_mask(values, pivotVector);
+        int count = _mm_popcnt_u32((unsigned int)less);
+        _mm512_mask_compressstoreu_epi32((void*)(array + writeLeft), less, values);
+        writeLeft += count;
+        writeRight -= W - count;
+        _mm512_mask_compressstoreu_epi32((void*)(array + writeRight), (__mmask16)~less, values);
+    }
+
+    int rest[3 * W];
+    _mm512_storeu_si512((void*)rest, savedLeft);
+    _mm512_storeu_si512((void*)(rest + W), savedRight);
+    int count = 2 * W;
+    for (std::ptrdiff_t i = readLeft; i < readRight; i++)
+    {
+        rest[count++] = array[i];
+    }
+    return finishSimdPartition(array, rest, count, writeLeft, writeRight, pivot);
+}
+
+//Structure to hold the AVX2 compress table: for each 8-bit mask, the lanes with the bit set followed by the others
+struct simdCompressTable
+{
+    uint8_t lanes[256][8];
+
+    simdCompressTable()
+    {
+        for (int mask = 0; mask < 256; mask++)
+        {
+            int count = 0;
+            for (int lane = 0; lane < 8; lane++)
+            {
+                if (mask & (1 << lane)) lanes[mask][count++] = (uint8_t)lane;
+            }
+            for (int lane = 0; lane < 8; lane++)
+            {
+                if (!(mask & (1 << lane))) lanes[mask][count++] = (uint8_t)lane;
+            }
+        }
+    }
+};
+
+//Function to partition array[first..last - 1] so elements < pivot come first with AVX2, returns the boundary
+//AVX2 has no compress store, so each vector is permuted through a lookup table to put its elements < pivot first and
+//the rest after them. The whole vector is then stored at the left write position and again ending at the right one;
+//the lanes that land on the wrong side fall in free space and are overwritten later.
+__attribute__((target("avx2,popcnt")))
+inline std::ptrdiff_t simdPartitionAvx2(int array[], std::ptrdiff_t first, std::ptrdiff_t last, int pivot)
+{
+    const int W = 8;
+    static const simdCompressTable table;
+    const __m256i pivotVector = _mm256_set1_epi32(pivot);
+
+    __m256i savedLeft = _mm256_loadu_si256((const __m256i*)(array + first));
+    __m256i savedRight = _mm256_loadu_si256((const __m256i*)(array + last - W));
+    std::ptrdiff_t readLeft = first + W, readRight = last - W;
+    std::ptrdiff_t writeLeft = first, writeRight = last;
+
+    while (readRight - readLeft >= W)
+    {
+        __m256i values;
+        if (readLeft - writeLeft <= writeRight - readRight)
+        {
+            values = _mm256_loadu_si256((const __m256i*)(array + readLeft));
+            readLeft += W;
+        }
+        else
+        {
+            readRight -= W;
+            values = _mm256_loadu_si256((const __m256i*)(array + readRight));
+        }
+
+        __m256i less = _mm256_cmpgt_epi32(pivotVector, values);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(less));
+        int count = _mm_popcnt_u32((unsigned int)mask);
+        __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)table.lanes[mask]));
+        __m256i packed = _mm256_permutevar8x32_epi32(values, lanes);
+
+        _mm256_storeu_si256((__m256i*)(array + writeLeft), packed);
+        writeLeft += count;
+        writeRight -= W - count;
+        _mm256_storeu_si256((__m256i*)(array + writeRight - count), packed);
+    }
+
+    int rest[3 * W];
+    _mm256_storeu_si256((__m256i*)rest, savedLeft);
+    _mm256_storeu_si256((__m256i*)(rest + W), savedRight);
+    int count = 2 * W;
+    for (std::ptrdiff_t i = readLeft; i < readRight; i++)
+    {
+        rest[count++] = array[i];
+    }
+    return finishSimdPartition(array, rest, count, writeLeft, writeRight, pivot);
+}
+
+#endif
+
+//ENTRY POINT SECTION -----------------------------------------------------------------------
+
+//Function to sort array[0..n - 1] (n <= SIMD_NETWORK_MAX) with a bitonic sorting network
+//The block is padded with INT_MAX up to a power of two, which sorts to the end. Returns false if no SIMD is available.
+inline bool simdSortSmall(int array[], int n)
+{
+#ifdef SIMD_SORT_X86
+    SimdLevel level = activeSimdLevel();
+    if (level == SIMD_SCALAR || n > SIMD_NETWORK_MAX)
+    {
+        return false;
+    }
+
+    int size = (level == SIMD_AVX512) ? 16 : 8;
+    while (size < n)
+    {
+        size <<= 1;
+    }
+
+    alignas(64) int buf[SIMD_NETWORK_MAX];
+    memcpy(buf, array, n * sizeof(int));
+    for (int i = n; i < size; i++)
+    {
+        buf[i] = INT_MAX;
+    }
+
+    if (level == SIMD_AVX512)
+    {
+        bitonicSortAvx512(buf, size);
+    }
+    else
+    {
+        bitonicSortAvx2(buf, size);
+    }
+
+    memcpy(array, buf, n * sizeof(int));
+    return true;
+#else
+    (void)array;
+    (void)n;
+    return false;
+#endif
+}
+
+//Function to partition array[first..last - 1] so elements < pivot come first, returns the boundary or -1 if no SIMD
+//partition is available (or the range is too short for one), in which case the caller uses a scalar partition.
+inline std::ptrdiff_t simdPartitionRange(int array[], std::ptrdiff_t first, std::ptrdiff_t last, int pivot)
+{
+#ifdef SIMD_SORT_X86
+    SimdLevel level = activeSimdLevel();
+    if (level == SIMD_AVX512 && last - first >= 2 * 16)
+    {
+        return simdPartitionAvx512(array, first, last, pivot);
+    }
+    if (level >= SIMD_AVX2 && last - first >= 2 * 8)
+    {
+        return simdPartitionAvx2(array, first, last, pivot);
+    }
+#else
+    (void)array;
+    (void)first;
+    (void)last;
+    (void)pivot;
+#endif
+    return -1;
+}
+
+#endif
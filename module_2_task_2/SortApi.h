@@ -0,0 +1,138 @@
+#ifndef SORT_API_H
+#define SORT_API_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include "SortEngine.h"
+
+//Generic entry points on top of the sort engine for anything other than a plain int array: 64-bit keys, doubles,
+//(key, payload) records and structs sorted by one of their fields.
+//A key extractor is a callable returning the key of an element, a comparator is a strict weak ordering on keys.
+
+//SORT SECTION ------------------------------------------------------------------------------
+
+//Function to sort array[0..n - 1] with a comparator on whole elements
+template <typename T, typename Less>
+inline void sortBy(T array[], std::ptrdiff_t n, Less less)
+{
+    introSortBy(array, 0, n - 1, less);
+}
+
+//Function to sort array[0..n - 1] by the key extracted with key, in the order given by compare (ascending by default)
+template <typename T, typename KeyOf, typename Compare = std::less<>>
+inline void sortByKey(T array[], std::ptrdiff_t n, KeyOf key, Compare compare = Compare())
+{
+    introSortBy(array, 0, n - 1, [&](const T &a, const T &b) { return compare(key(a), key(b)); });
+}
+
+//ARGSORT SECTION ---------------------------------------------------------------------------
+
+//True when argsort can skip the comparator and sort the integer keys directly (plain ascending order)
+template <typename Key, typename Compare>
+constexpr bool argsortFastPath = std::is_integral<Key>::value && !std::is_same<Key, bool>::value
+                                 && (std::is_same<Compare, std::less<>>::value || std::is_same<Compare, std::less<Key>>::value);
+
+//Function to map an integer key to an unsigned value with the same order (the sign bit is flipped for signed types)
+template <typename Key>
+inline uint64_t orderedKeyBits(Key key)
+{
+    if constexpr (std::is_signed<Key>::value)
+    {
+        return (uint64_t)(int64_t)key ^ 0x8000000000000000ull;
+    }
+    else
+    {
+        return (uint64_t)key;
+    }
+}
+
+//Structure to hold a 64-bit key and the index it came from, for the 64-bit argsort fast path
+struct keyIndexPair
+{
+    uint64_t key;
+    int index;
+};
+
+//Function to return the permutation that sorts array[0..n - 1] by key: array[order[0]], array[order[1]], ... is sorted
+//Elements with equal keys keep their original order, so the result is the same as a stable sort.
+//Integer keys in ascending order take a fast path that sorts the keys and indices together in one contiguous array
+//instead of comparing through the index into array:
+//- keys of 32 bits or fewer are packed with their index into one 64-bit integer, so ties break on the index for free
+//- wider keys are sorted as (key, index) pairs
+//Any other key type or comparator sorts the index array with an indirect comparator.
+template <typename T, typename KeyOf, typename Compare = std::less<>>
+inline std::vector<int> argsort(const T array[], int n, KeyOf key, Compare compare = Compare())
+{
+    typedef typename std::decay<decltype(key(array[0]))>::type Key;
+    std::vector<int> order(n);
+
+    if constexpr (argsortFastPath<Key, Compare> && sizeof(Key) <= 4)
+    {
+        std::vector<uint64_t> packed(n);
+        for (int i = 0; i < n; i++)
+        {
+            Key value = key(array[i]);
+            uint32_t bits = std::is_signed<Key>::value ? ((uint32_t)(int32_t)value ^ 0x80000000u) : (uint32_t)value;
+            packed[i] = ((uint64_t)bits << 32) | (uint32_t)i;
+        }
+        introSort(packed.data(), 0, n - 1);
+        for (int i = 0; i < n; i++)
+        {
+            order[i] = (int)(uint32_t)packed[i];
+        }
+    }
+    else if constexpr (argsortFastPath<Key, Compare>)
+    {
+        std::vector<keyIndexPair> pairs(n);
+        for (int i = 0; i < n; i++)
+        {
+            pairs[i].key = orderedKeyBits(key(array[i]));
+            pairs[i].index = i;
+        }
+        introSortBy(pairs.data(), 0, n - 1, [](const keyIndexPair &a, const keyIndexPair &b)
+        {
+            return (a.key < b.key) || (a.key == b.key && a.index < b.index);
+        });
+        for (int i = 0; i < n; i++)
+        {
+            order[i] = pairs[i].index;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < n; i++)
+        {
+            order[i] = i;
+        }
+        introSortBy(order.data(), 0, n - 1, [&](int a, int b)
+        {
+            if (compare(key(array[a]), key(array[b]))) return true;
+            if (compare(key(array[b]), key(array[a]))) return false;
+            return a < b;
+        });
+    }
+
+    return order;
+}
+
+//Function to return the permutation that sorts an array of integers (or anything ordered by <)
+template <typename T>
+inline std::vector<int> argsort(const T array[], int n)
+{
+    return argsort(array, n, [](const T &value) -> const T& { return value; });
+}
+
+//Function to write array[order[i]] to output[i], moving the elements into the order argsort returned
+template <typename T>
+inline void applyPermutation(const T array[], const std::vector<int> &order, T output[])
+{
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        output[i] = array[order[i]];
+    }
+}
+
+#endif
@@ -0,0 +1,420 @@
+#ifndef SORT_ENGINE_H
+#define SORT_ENGINE_H
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "SimdSort.h"
+
+//Shared sort engine used by the sequential, OpenMP and MPI QuickSort programs.
+//It is an introsort: quicksort with a ninther/median-of-three pivot and three-way (or branchless block or SIMD)
+//partitioning, insertion sort (or a sorting network) for small subarrays and a heapsort fallback once the recursion
+//gets too deep.
+//Every function is a template over the element type T and a strict weak ordering less (std::less<T> by default), so the
+//int programs call it unchanged and SortApi.h builds key, record and argsort entry points on top of it.
+//Positions and sizes are std::ptrdiff_t so arrays of more than 2^31 elements sort correctly.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Subarrays at or below this size are finished with insertion sort
+const int INSERTION_SORT_CUTOFF = 16;
+
+//Subarrays above this size use Tukey's ninther instead of a plain median of three
+const int NINTHER_CUTOFF = 128;
+
+//Number of elements classified at a time by the block partition (offsets must fit in an unsigned char)
+const int PARTITION_BLOCK_SIZE = 64;
+
+//Partition schemes the engine can use, chosen once per run through partitionScheme
+enum PartitionScheme
+{
+    PARTITION_THREE_WAY,
+    PARTITION_BLOCK,
+    PARTITION_SIMD
+};
+
+//Partition scheme used by partitionRange (and therefore by introSort)
+inline PartitionScheme partitionScheme = PARTITION_THREE_WAY;
+
+//True when the SIMD kernels apply: they only handle plain ints in ascending order, anything else that asks for the
+//SIMD scheme gets the block partition and insertion sort instead
+template <typename T, typename Less>
+constexpr bool simdSortable = std::is_same<T, int>::value && std::is_same<Less, std::less<int>>::value;
+
+//INSERTION SORT AND HEAPSORT SECTION -------------------------------------------------------
+
+//Function to insertion sort array[low..high]
+template <typename T, typename Less = std::less<T>>
+inline void insertionSort(T array[], std::ptrdiff_t low, std::ptrdiff_t high, Less less = Less())
+{
+    for (std::ptrdiff_t i = low + 1; i <= high; i++)
+    {
+        T value = std::move(array[i]);
+        std::ptrdiff_t j = i - 1;
+        while (j >= low && less(value, array[j]))
+        {
+            array[j + 1] = std::move(array[j]);
+            j--;
+        }
+        array[j + 1] = std::move(value);
+    }
+}
+
+//Function to move array[low + root] down the max-heap stored in array[low..low + count - 1]
+template <typename T, typename Less = std::less<T>>
+inline void siftDown(T array[], std::ptrdiff_t low, std::ptrdiff_t root, std::ptrdiff_t count, Less less = Less())
+{
+    T value = std::move(array[low + root]);
+    while (true)
+    {
+        std::ptrdiff_t child = 2 * root + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && less(array[low + child], array[low + child + 1]))
+        {
+            child++;
+        }
+        if (!less(value, array[low + child]))
+        {
+            break;
+        }
+        array[low + root] = std::move(array[low + child]);
+        root = child;
+    }
+    array[low + root] = std::move(value);
+}
+
+//Function to heapsort array[low..high], used when quicksort recursion goes too deep
+template <typename T, typename Less = std::less<T>>
+inline void heapSort(T array[], std::ptrdiff_t low, std::ptrdiff_t high, Less less = Less())
+{
+    std::ptrdiff_t count = high - low + 1;
+    for (std::ptrdiff_t root = count / 2 - 1; root >= 0; root--)
+    {
+        siftDown(array, low, root, count, less);
+    }
+    for (std::ptrdiff_t end = count - 1; end > 0; end--)
+    {
+        std::swap(array[low], array[low + end]);
+        siftDown(array, low, 0, end, less);
+    }
+}
+
+//PIVOT SELECTION SECTION -------------------------------------------------------------------
+
+//Function to return the index of the median of array[a], array[b] and array[c]
+template <typename T, typename Less = std::less<T>>
+inline std::ptrdiff_t medianOfThree(T array[], std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c, Less less = Less())
+{
+    if (less(array[a], array[b]))
+    {
+        if (less(array[b], array[c])) return b;
+        return less(array[a], array[c]) ? c : a;
+    }
+    if (less(array[a], array[c])) return a;
+    return less(array[b], array[c]) ? c : b;
+}
+
+//Function to choose a pivot value for array[low..high]
+//Small ranges use the median of the first, middle and last element, larger ranges use Tukey's ninther
+//(the median of three medians of three), which holds up on sorted, reverse sorted and organ pipe inputs.
+//The pivot is returned as a copy because partitioning moves the element it came from.
+template <typename T, typename Less = std::less<T>>
+inline T selectPivot(T array[], std::ptrdiff_t low, std::ptrdiff_t high, Less less = Less())
+{
+    std::ptrdiff_t count = high - low + 1;
+    std::ptrdiff_t mid = low + count / 2;
+
+    if (count > NINTHER_CUTOFF)
+    {
+        std::ptrdiff_t step = count / 8;
+        std::ptrdiff_t first = medianOfThree(array, low, low + step, low + 2 * step, less);
+        std::ptrdiff_t middle = medianOfThree(array, mid - step, mid, mid + step, less);
+        std::ptrdiff_t last = medianOfThree(array, high - 2 * step, high - step, high, less);
+        return array[medianOfThree(array, first, middle, last, less)];
+    }
+
+    return array[medianOfThree(array, low, mid, high, less)];
+}
+
+//PARTITION SECTION -------------------------------------------------------------------------
+
+//Function to perform three-way partitioning of array[low..high] around pivot
+//Afterwards array[low..lessEnd - 1] < pivot, array[lessEnd..greaterStart] == pivot
+//and array[greaterStart + 1..high] > pivot, so runs of equal keys are never recursed into again.
+template <typename T, typename Less = std::less<T>>
+inline void partitionThreeWay(T array[], std::ptrdiff_t low, std::ptrdiff_t high, const T &pivot, std::ptrdiff_t &lessEnd, std::ptrdiff_t &greaterStart, Less less = Less())
+{
+    std::ptrdiff_t lt = low;
+    std::ptrdiff_t i = low;
+    std::ptrdiff_t gt = high;
+
+    while (i <= gt)
+    {
+        if (less(array[i], pivot))
+        {
+            std::swap(array[lt], array[i]);
+            lt++;
+            i++;
+        }
+        else if (less(pivot, array[i]))
+        {
+            std::swap(array[i], array[gt]);
+            gt--;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    lessEnd = lt;
+    greaterStart = gt;
+}
+
+//Function to partition array[first..last - 1] so elements that go left come first, returns the boundary
+//An element goes left if it is < pivot, or <= pivot when Inclusive is true.
+//BlockQuickSort scheme: a block of elements is classified from each end without branching, by writing every
+//offset and only advancing the count when the element is on the wrong side. The misplaced elements from the two
+//blocks are then swapped in a batch, so the only branches left are the loop conditions.
+template <bool Inclusive, typename T, typename Less = std::less<T>>
+inline std::ptrdiff_t blockPartitionRange(T array[], std::ptrdiff_t first, std::ptrdiff_t last, const T &pivot, Less less = Less())
+{
+    unsigned char offsetsLeft[PARTITION_BLOCK_SIZE];
+    unsigned char offsetsRight[PARTITION_BLOCK_SIZE];
+    int startLeft = 0, countLeft = 0;
+    int startRight = 0, countRight = 0;
+    std::ptrdiff_t l = first;
+    std::ptrdiff_t r = last;
+
+    while (r - l > 2 * PARTITION_BLOCK_SIZE)
+    {
+        if (countLeft == 0)
+        {
+            startLeft = 0;
+            for (int j = 0; j < PARTITION_BLOCK_SIZE; j++)
+            {
+                const T &value = array[l + j];
+                offsetsLeft[countLeft] = (unsigned char)j;
+                countLeft += Inclusive ? less(pivot, value) : !less(value, pivot);
+            }
+        }
+        if (countRight == 0)
+        {
+            startRight = 0;
+            for (int j = 0; j < PARTITION_BLOCK_SIZE; j++)
+            {
+                const T &value = array[r - 1 - j];
+                offsetsRight[countRight] = (unsigned char)j;
+                countRight += Inclusive ? !less(pivot, value) : less(value, pivot);
+            }
+        }
+
+        int count = std::min(countLeft, countRight);
+        for (int k = 0; k < count; k++)
+        {
+            std::swap(array[l + offsetsLeft[startLeft + k]], array[r - 1 - offsetsRight[startRight + k]]);
+        }
+        countLeft -= count;
+        countRight -= count;
+        startLeft += count;
+        startRight += count;
+
+        if (countLeft == 0) l += PARTITION_BLOCK_SIZE;
+        if (countRight == 0) r -= PARTITION_BLOCK_SIZE;
+    }
+
+    //Everything before l already goes left and everything from r goes right,
+    //so the at most 2 * PARTITION_BLOCK_SIZE elements in between are finished with a plain scan
+    for (std::ptrdiff_t j = l; j < r; j++)
+    {
+        bool goesLeft = Inclusive ? !less(pivot, array[j]) : less(array[j], pivot);
+        if (goesLeft)
+        {
+            std::swap(array[l], array[j]);
+            l++;
+        }
+    }
+
+    return l;
+}
+
+//Function to perform block partitioning of array[low..high] around pivot, with the same result contract as partitionThreeWay
+//Elements equal to the pivot normally stay on the right with an empty equal range. When nothing is smaller than the
+//pivot (the pivot is the minimum, which is what duplicate heavy input produces) a second pass gathers every copy of the
+//pivot into the equal range, so runs of equal keys still finish in linear time.
+template <typename T, typename Less = std::less<T>>
+inline void partitionBlock(T array[], std::ptrdiff_t low, std::ptrdiff_t high, const T &pivot, std::ptrdiff_t &lessEnd, std::ptrdiff_t &greaterStart, Less less = Less())
+{
+    std::ptrdiff_t boundary = blockPartitionRange<false>(array, low, high + 1, pivot, less);
+
+    if (boundary == low)
+    {
+        lessEnd = low;
+        greaterStart = blockPartitionRange<true>(array, low, high + 1, pivot, less) - 1;
+        return;
+    }
+
+    lessEnd = boundary;
+    greaterStart = boundary - 1;
+}
+
+//Function to perform vectorised partitioning of array[low..high] around pivot, with the same result contract as partitionThreeWay
+//Uses the AVX-512 or AVX2 kernel from SimdSort.h and falls back to the block partition when neither is available.
+inline void partitionSimd(int array[], std::ptrdiff_t low, std::ptrdiff_t high, int pivot, std::ptrdiff_t &lessEnd, std::ptrdiff_t &greaterStart)
+{
+    std::ptrdiff_t boundary = simdPartitionRange(array, low, high + 1, pivot);
+    if (boundary < 0)
+    {
+        partitionBlock(array, low, high, pivot, lessEnd, greaterStart);
+        return;
+    }
+
+    //Same duplicate handling as partitionBlock
+    if (boundary == low)
+    {
+        lessEnd = low;
+        greaterStart = blockPartitionRange<true>(array, low, high + 1, pivot) - 1;
+        return;
+    }
+
+    lessEnd = boundary;
+    greaterStart = boundary - 1;
+}
+
+//Function to choose a pivot and partition array[low..high] with the active partition scheme
+template <typename T, typename Less = std::less<T>>
+inline void partitionRange(T array[], std::ptrdiff_t low, std::ptrdiff_t high, std::ptrdiff_t &lessEnd, std::ptrdiff_t &greaterStart, Less less = Less())
+{
+    T pivot = selectPivot(array, low, high, less);
+
+    if constexpr (simdSortable<T, Less>)
+    {
+        if (partitionScheme == PARTITION_SIMD)
+        {
+            partitionSimd(array, low, high, pivot, lessEnd, greaterStart);
+            return;
+        }
+    }
+
+    if (partitionScheme != PARTITION_THREE_WAY)
+    {
+        partitionBlock(array, low, high, pivot, lessEnd, greaterStart, less);
+    }
+    else
+    {
+        partitionThreeWay(array, low, high, pivot, lessEnd, greaterStart, less);
+    }
+}
+
+//Function to return the display name of a partition scheme
+inline const char* partitionSchemeName(PartitionScheme scheme)
+{
+    if (scheme == PARTITION_SIMD) return "SIMD";
+    return (scheme == PARTITION_BLOCK) ? "Block" : "Three-Way";
+}
+
+//Function to return the size at or below which introsort finishes a subarray without partitioning
+//The SIMD scheme hands whole blocks of up to SIMD_NETWORK_MAX elements to a sorting network when the CPU has one.
+template <typename T, typename Less>
+inline int smallSortCutoff()
+{
+    if constexpr (simdSortable<T, Less>)
+    {
+        if (partitionScheme == PARTITION_SIMD && activeSimdLevel() != SIMD_SCALAR)
+        {
+            return SIMD_NETWORK_MAX;
+        }
+    }
+    return INSERTION_SORT_CUTOFF;
+}
+
+//Function to sort a small subarray array[low..high] (at most smallSortCutoff() elements)
+template <typename T, typename Less>
+inline void smallSort(T array[], std::ptrdiff_t low, std::ptrdiff_t high, Less less)
+{
+    if constexpr (simdSortable<T, Less>)
+    {
+        if (partitionScheme == PARTITION_SIMD && high > low && simdSortSmall(array + low, (int)(high - low + 1)))
+        {
+            return;
+        }
+    }
+    insertionSort(array, low, high, less);
+}
+
+//INTROSORT SECTION -------------------------------------------------------------------------
+
+//Function to compute the recursion depth after which introsort switches to heapsort (2 * log2(n))
+inline int introSortDepthLimit(std::ptrdiff_t size)
+{
+    int depth = 0;
+    while (size > 1)
+    {
+        size >>= 1;
+        depth++;
+    }
+    return 2 * depth;
+}
+
+//Introsort main loop
+//Recurses into the smaller side and loops on the larger one, so the stack depth stays O(log n).
+template <typename T, typename Less>
+inline void introSortLoop(T array[], std::ptrdiff_t low, std::ptrdiff_t high, int depthLimit, Less less)
+{
+    const int cutoff = smallSortCutoff<T, Less>();
+    while (high - low + 1 > cutoff)
+    {
+        if (depthLimit == 0)
+        {
+            heapSort(array, low, high, less);
+            return;
+        }
+        depthLimit--;
+
+        std::ptrdiff_t lessEnd, greaterStart;
+        partitionRange(array, low, high, lessEnd, greaterStart, less);
+
+        if (lessEnd - low < high - greaterStart)
+        {
+            introSortLoop(array, low, lessEnd - 1, depthLimit, less);
+            low = greaterStart + 1;
+        }
+        else
+        {
+            introSortLoop(array, greaterStart + 1, high, depthLimit, less);
+            high = lessEnd - 1;
+        }
+    }
+
+    smallSort(array, low, high, less);
+}
+
+//Function to sort array[low..high] with introsort and an explicit depth limit
+template <typename T, typename Less = std::less<T>>
+inline void introSort(T array[], std::ptrdiff_t low, std::ptrdiff_t high, int depthLimit, Less less = Less())
+{
+    if (low < high)
+    {
+        introSortLoop(array, low, high, depthLimit, less);
+    }
+}
+
+//Function to sort array[low..high] with introsort
+template <typename T>
+inline void introSort(T array[], std::ptrdiff_t low, std::ptrdiff_t high)
+{
+    introSort(array, low, high, introSortDepthLimit(high - low + 1), std::less<T>());
+}
+
+//Function to sort array[low..high] with introsort and a custom ordering
+template <typename T, typename Less>
+inline void introSortBy(T array[], std::ptrdiff_t low, std::ptrdiff_t high, Less less)
+{
+    introSort(array, low, high, introSortDepthLimit(high - low + 1), less);
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef SORT_VERIFY_H
+#define SORT_VERIFY_H
+
+#include <cstddef>
+
+//Parallel check that a sort's output is in order and is a permutation of its input.
+//A sort that drops or duplicates elements can still leave the array in order, so besides counting out of order
+//neighbours the output's multiset hash is compared with the input's. The hash is the sum of a bijective mix of every
+//element, so it doesn't depend on the order, and replacing any one element always changes it.
+//Both passes are a single streaming read with a few integer operations per element, so they run at memory bandwidth
+//and can stay on for every benchmark run. Without OpenMP (QuickSortSeq) the loops run sequentially.
+
+//CONFIGURATION SECTION ------------------------------------------------------------------
+
+//Seed mixed into every element before hashing
+const unsigned long long MULTISET_HASH_SEED = 0x9E3779B97F4A7C15ULL;
+
+//Structure to hold the result of checking a sort's output
+struct sortCheck
+{
+    std::ptrdiff_t descents;    //Neighbours out of order, 0 when sorted
+    bool permutation;           //True when the output has the same multiset hash as the input
+};
+
+//HASH SECTION ------------------------------------------------------------------------------
+
+//Function to mix one element into 64 bits
+//Each step (xor, multiply by an odd constant, xor-shift) is invertible, so different values never mix to the same bits.
+inline unsigned long long multisetMix(int value)
+{
+    unsigned long long h = ((unsigned long long)(unsigned int)value ^ MULTISET_HASH_SEED) * 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 31;
+    return h * 0x94D049BB133111EBULL;
+}
+
+//Function to return the order independent hash of the multiset array[0..size - 1], computed in parallel
+inline unsigned long long multisetHash(const int array[], std::ptrdiff_t size)
+{
+    unsigned long long hash = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for simd reduction(+:hash) schedule(static)
+#endif
+    for (std::ptrdiff_t i = 0; i < size; i++)
+    {
+        hash += multisetMix(array[i]);
+    }
+    return hash;
+}
+
+//VERIFY SECTION ----------------------------------------------------------------------------
+
+//Function to check array[0..size - 1] after a sort against the multiset hash of its input
+//Order and hash are checked in the same pass, so the output is only read once.
+inline sortCheck checkSortedPermutation(const int array[], std::ptrdiff_t size, unsigned long long inputHash)
+{
+    unsigned long long hash = 0;
+    std::ptrdiff_t descents = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for simd reduction(+:hash, descents) schedule(static)
+#endif
+    for (std::ptrdiff_t i = 0; i < size; i++)
+    {
+        hash += multisetMix(array[i]);
+        descents += (i + 1 < size && array[i] > array[i + 1]);
+    }
+    return {descents, hash == inputHash};
+}
+
+//Function to check that a sort's output is both in order and a permutation of its input
+inline bool verifySortedPermutation(const int array[], std::ptrdiff_t size, unsigned long long inputHash)
+{
+    sortCheck check = checkSortedPermutation(array, size, inputHash);
+    return check.descents == 0 && check.permutation;
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include "TrafficInput.h"
+
+using namespace std;
+
+//Formats number with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Main function, converts a text data file to the binary record format
+//Usage: ConvertData [input (data.txt)] [output (data.bin)]
+int main(int argc, char* argv[]) {
+    const char* input_path = (argc > 1) ? argv[1] : "data.txt";
+    const char* output_path = (argc > 2) ? argv[2] : "data.bin";
+
+    auto start = chrono::high_resolution_clock::now();
+
+    trafficInput in;
+    if (!openTrafficInput(in, input_path, false)) {
+        cout << "Error opening " << input_path << endl;
+        return 1;
+    }
+    if (in.binary) {
+        cout << input_path << " is already a binary file" << endl;
+        closeTrafficInput(in);
+        return 1;
+    }
+
+    ofstream out(output_path, ios::binary);
+    if (!out) {
+        cout << "Error opening " << output_path << endl;
+        closeTrafficInput(in);
+        return 1;
+    }
+
+    //The record count isn't known until the end, the header is written again once it is
+    uint64_t records = 0;
+    long long skipped = 0;
+    writeBinaryHeader(out, 0);
+    scanTrafficRecords(in, [&](const trafficRecord& record) {
+        if (writeBinaryRecord(out, record)) {
+            records++;
+        } else {
+            skipped++;
+        }
+    });
+    out.seekp(0);
+    writeBinaryHeader(out, records);
+    out.close();
+    size_t text_size = in.file.size;
+    closeTrafficInput(in);
+
+    if (!out) {
+        cout << "Error writing " << output_path << endl;
+        return 1;
+    }
+
+    auto end = chrono::high_resolution_clock::now();
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    cout << "Converted " << formatWithCommas(records) << " records from " << input_path << " to " << output_path << endl;
+    cout << formatWithCommas(text_size) << " bytes of text became " << formatWithCommas(sizeof(binaryHeader) + records * sizeof(binaryRecord)) << " bytes" << endl;
+    if (skipped > 0) {
+        cout << formatWithCommas(skipped) << " records were skipped because they don't fit the binary fields" << endl;
+    }
+    cout << "Processing time: " << formatWithCommas(elapsed.count()) << " microseconds" << endl;
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include "TrafficInput.h"
 
 using namespace std;
 
@@ -14,17 +15,34 @@ int main() {
     cin >> numLights;
     cout << "Enter number of hours: ";
     cin >> numHours;
+    int format;
+    cout << "Enter output format (1 = text data.txt, 2 = binary data.bin, 3 = both): ";
+    cin >> format;
+    bool writeText = (format == 1 || format == 3);
+    bool writeBinary = (format == 2 || format == 3);
 
-    ofstream out("data.txt");
-    if (!out) {
-        cout << "Error opening file" << endl;
-        return 1;
+    ofstream out;
+    if (writeText) {
+        out.open("data.txt");
+        if (!out) {
+            cout << "Error opening file" << endl;
+            return 1;
+        }
+    }
+    ofstream binaryOut;
+    if (writeBinary) {
+        binaryOut.open("data.bin", ios::binary);
+        if (!binaryOut) {
+            cout << "Error opening file" << endl;
+            return 1;
+        }
+        writeBinaryHeader(binaryOut, (uint64_t)numHours * 12 * numLights);
     }
 
     int totalMeasurements = numHours * 12;
     int hour = 0;
     int minute = 0;
-    int day = 1;
+    int day = daysFromCivil(2025, 1, 1); //Days since 1970-01-01
     string date = "2025-01-01";
 
     for(int i = 0; i < totalMeasurements; i++) {
@@ -33,7 +51,12 @@ int main() {
 
         for(int light = 1; light <= numLights; light++) {
             int cars = rand() % 101;
-            out << timestamp << " " << light << " " << cars << endl;
+            if (writeText) {
+                out << timestamp << " " << light << " " << cars << "\n";
+            }
+            if (writeBinary) {
+                writeBinaryRecord(binaryOut, {(day * 24 + hour) * 60 + minute, light, cars});
+            }
         }
 
         minute += 5;
@@ -43,12 +66,18 @@ int main() {
             if(hour == 24) {
                 hour = 0;
                 day++;
-                date = "2025-01-" + string(day < 10 ? "0" : "") + to_string(day);
+                date = formatHour(day * 24).substr(0, 10);
             }
         }
     }
 
-    out.close();
-    cout << "Data generated in data.txt" << endl;
+    if (writeText) {
+        out.close();
+        cout << "Data generated in data.txt" << endl;
+    }
+    if (writeBinary) {
+        binaryOut.close();
+        cout << "Data generated in data.bin" << endl;
+    }
     return 0;
 }
@@ -0,0 +1,181 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include "TrafficInput.h"
+
+using namespace std;
+
+//Formats number with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Construct to hold a parsed line: its text date and time for the string keyed map, and its record
+struct ParsedLine {
+    string_view date;
+    string_view time;
+    trafficRecord record;
+};
+
+//Writes the top N lights of one hour the way the simulators do
+void writeTopLights(ostringstream& out, const string& hour, vector<pair<long long, int>>& vec, int N) {
+    sort(vec.rbegin(), vec.rend());
+    out << "Top " << N << " congested lights for hour " << hour << ":" << endl;
+    for (int i = 0; i < min(N, (int)vec.size()); i++) {
+        out << "  Light " << vec[i].second << ": " << vec[i].first << " cars" << endl;
+    }
+    out << endl;
+}
+
+//Writes the results of a nested map keyed by hour string or hour index
+template <typename Key>
+string mapResults(const map<Key, map<int, int>>& hour_to_light, int N) {
+    ostringstream out;
+    for (auto& hour_entry : hour_to_light) {
+        vector<pair<long long, int>> vec;
+        for (auto& p : hour_entry.second) {
+            vec.push_back({p.second, p.first});
+        }
+        if constexpr (is_same<Key, string>::value) {
+            writeTopLights(out, hour_entry.first, vec, N);
+        } else {
+            writeTopLights(out, formatHour(hour_entry.first), vec, N);
+        }
+    }
+    return out.str();
+}
+
+//Writes the results of an aggregation table
+string tableResults(const hourLightTable& table, int N) {
+    ostringstream out;
+    forEachHour(table, [&](int hour, vector<pair<long long, int>>& vec) {
+        writeTopLights(out, formatHour(hour), vec, N);
+    });
+    return out.str();
+}
+
+//Main function
+//Every line of data.txt is parsed once, then the records are aggregated into each structure 10 times. Only the
+//aggregation is timed, and every structure must produce the same top N results as the original string keyed map.
+int main(int argc, char* argv[]) {
+    const char* input_path = (argc > 1) ? argv[1] : "data.txt";
+    const int runs = 10;
+    const int N = 5;
+
+    trafficInput in;
+    if (!openTrafficInput(in, input_path, true) || in.binary) {
+        cout << "Error opening " << input_path << " (a text data file is needed)" << endl;
+        return 1;
+    }
+    vector<ParsedLine> parsed;
+    parsed.reserve(in.lines.size());
+    for (string_view line : in.lines) {
+        ParsedLine entry;
+        int light, cars;
+        if (parseTrafficLine(line, entry.date, entry.time, light, cars) && parseTrafficRecord(line, entry.record)) {
+            parsed.push_back(entry);
+        }
+    }
+
+    std::ofstream out("HourTableBenchmarkResults.md");
+    if (!out) {
+        cout << "Error opening HourTableBenchmarkResults.md" << endl;
+        return 1;
+    }
+
+    const char* names[] = {"map<string, map<int, int>>", "map<int, map<int, int>>", "hourLightTable (hash)", "hourLightTable (dense)"};
+    const int structures = 4;
+    long long total_time[structures] = {0, 0, 0, 0};
+    string results[structures];
+
+    for (int run = 0; run < runs; ++run) {
+        for (int structure = 0; structure < structures; ++structure) {
+            auto start = chrono::high_resolution_clock::now();
+            if (structure == 0) {
+                map<string, map<int, int>> hour_to_light;
+                for (const ParsedLine& entry : parsed) {
+                    string hour = string(entry.date) + " " + string(entry.time.substr(0, 2));
+                    hour_to_light[hour][entry.record.light] += entry.record.cars;
+                }
+                auto end = chrono::high_resolution_clock::now();
+                total_time[structure] += chrono::duration_cast<chrono::microseconds>(end - start).count();
+                results[structure] = mapResults(hour_to_light, N);
+            } else if (structure == 1) {
+                map<int, map<int, int>> hour_to_light;
+                for (const ParsedLine& entry : parsed) {
+                    hour_to_light[entry.record.minute / 60][entry.record.light] += entry.record.cars;
+                }
+                auto end = chrono::high_resolution_clock::now();
+                total_time[structure] += chrono::duration_cast<chrono::microseconds>(end - start).count();
+                results[structure] = mapResults(hour_to_light, N);
+            } else {
+                //The dense table's ranges come from a pass over the records, which is timed with it
+                hourLightTable hour_to_light;
+                if (structure == 3 && !parsed.empty()) {
+                    hourLightRanges ranges = {parsed[0].record.minute / 60, parsed[0].record.minute / 60, parsed[0].record.light, parsed[0].record.light};
+                    for (const ParsedLine& entry : parsed) {
+                        ranges.first_hour = min(ranges.first_hour, entry.record.minute / 60);
+                        ranges.last_hour = max(ranges.last_hour, entry.record.minute / 60);
+                        ranges.first_light = min(ranges.first_light, entry.record.light);
+                        ranges.last_light = max(ranges.last_light, entry.record.light);
+                    }
+                    initHourLightTable(hour_to_light, ranges);
+                } else {
+                    initHourLightTable(hour_to_light);
+                }
+                for (const ParsedLine& entry : parsed) {
+                    addCars(hour_to_light, entry.record.minute / 60, entry.record.light, entry.record.cars);
+                }
+                auto end = chrono::high_resolution_clock::now();
+                total_time[structure] += chrono::duration_cast<chrono::microseconds>(end - start).count();
+                results[structure] = tableResults(hour_to_light, N);
+            }
+        }
+    }
+
+    //Write table
+    out << "# Hour Table Benchmark Results\n";
+    out << "**Input:** " << input_path << ", " << formatWithCommas(parsed.size()) << " records, average of " << runs << " runs\n\n";
+    out << "| Structure | Avg Time (microseconds) | ns per Record | Speedup |\n";
+    out << "|---|---|---|---|\n";
+    long long baseline = total_time[0] / runs;
+    for (int structure = 0; structure < structures; ++structure) {
+        long long avg = total_time[structure] / runs;
+        double per_record = parsed.empty() ? 0.0 : avg * 1000.0 / parsed.size();
+        double speedup = (avg > 0) ? (double)baseline / avg : 0.0;
+        out << "| " << names[structure] << " | " << formatWithCommas(avg) << " | " << fixed << setprecision(1) << per_record
+            << " | " << setprecision(1) << speedup << "x |\n";
+        cout << names[structure] << ": " << formatWithCommas(avg) << " microseconds" << endl;
+
+        if (results[structure] != results[0]) {
+            out << "\n" << names[structure] << " did not produce the same results as map<string, map<int, int>>\n";
+            cout << "  Did not produce the same results as map<string, map<int, int>>" << endl;
+        }
+    }
+
+    out.close();
+    closeTrafficInput(in);
+    return 0;
+}
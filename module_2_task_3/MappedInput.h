@@ -0,0 +1,152 @@
+#ifndef MAPPED_INPUT_H
+#define MAPPED_INPUT_H
+
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+//Zero-copy input for the traffic simulators.
+//data.txt is mapped read-only into memory instead of being read line by line into strings, so no line is ever copied
+//or allocated: lines and fields are string_views pointing straight into the mapped pages. The mapping is marked
+//sequential so the kernel reads ahead and drops pages behind the scan.
+
+//Structure to hold a read-only mapping of a whole file
+struct mappedFile {
+    const char* data;
+    size_t size;
+};
+
+//FILE SECTION ------------------------------------------------------------------------------
+
+//Function to map the file at path, returns false if it can't be opened or mapped
+inline bool openMappedFile(mappedFile& file, const char* path) {
+    file.data = nullptr;
+    file.size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    file.size = (size_t)info.st_size;
+
+    //An empty file can't be mapped, it just has no lines
+    if (file.size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void* memory = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) return false;
+
+    madvise(memory, file.size, MADV_SEQUENTIAL);
+    madvise(memory, file.size, MADV_WILLNEED);
+    file.data = (const char*)memory;
+    return true;
+}
+
+//Function to unmap a file mapped with openMappedFile
+inline void closeMappedFile(mappedFile& file) {
+    if (file.data != nullptr) {
+        munmap((void*)file.data, file.size);
+    }
+    file.data = nullptr;
+    file.size = 0;
+}
+
+//LINE SECTION ------------------------------------------------------------------------------
+
+//Function to find the first newline in [position, end), end if there is none
+//The bytes are compared 32 (AVX2) or 16 (SSE2) at a time, the movemask of the comparison gives the newline's offset.
+inline const char* findNewline(const char* position, const char* end) {
+#if defined(__AVX2__)
+    const __m256i newline32 = _mm256_set1_epi8('\n');
+    while (end - position >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)position);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline32));
+        if (mask != 0) return position + __builtin_ctz(mask);
+        position += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i newline16 = _mm_set1_epi8('\n');
+    while (end - position >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)position);
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline16));
+        if (mask != 0) return position + __builtin_ctz(mask);
+        position += 16;
+    }
+#endif
+    while (position < end && *position != '\n') position++;
+    return position;
+}
+
+//Function to take the next line from [position, end), without its line ending, and move position past it
+//Returns false once there are no lines left.
+inline bool nextLine(const char*& position, const char* end, std::string_view& line) {
+    if (position >= end) return false;
+
+    const char* newline = findNewline(position, end);
+    line = std::string_view(position, newline - position);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    position = (newline < end) ? newline + 1 : end;
+    return true;
+}
+
+//Function to index every line of the file, for handing lines out to threads by number
+inline std::vector<std::string_view> splitLines(const mappedFile& file) {
+    std::vector<std::string_view> lines;
+    const char* position = file.data;
+    const char* end = file.data + file.size;
+    std::string_view line;
+    while (nextLine(position, end, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+//PARSE SECTION -----------------------------------------------------------------------------
+
+//Function to take the next space or tab separated field from rest (empty when there is none)
+inline std::string_view nextField(std::string_view& rest) {
+    size_t start = rest.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        rest = std::string_view();
+        return rest;
+    }
+    size_t stop = rest.find_first_of(" \t", start);
+    if (stop == std::string_view::npos) stop = rest.size();
+    std::string_view field = rest.substr(start, stop - start);
+    rest.remove_prefix(stop);
+    return field;
+}
+
+//Function to parse a whole field as an int, returns false if it isn't one
+inline bool parseInt(std::string_view field, int& value) {
+    if (field.empty()) return false;
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size();
+}
+
+//Function to split a "date time light cars" line into its fields, returns false for a malformed line
+inline bool parseTrafficLine(std::string_view line, std::string_view& date, std::string_view& time, int& light, int& cars) {
+    date = nextField(line);
+    time = nextField(line);
+    std::string_view light_str = nextField(line);
+    std::string_view cars_str = nextField(line);
+    return !date.empty() && !time.empty() && parseInt(light_str, light) && parseInt(cars_str, cars);
+}
+
+#endif
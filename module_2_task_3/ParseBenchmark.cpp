@@ -0,0 +1,145 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include "TrafficParser.h"
+
+using namespace std;
+
+//Formats number with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Construct to hold what a parser read: records, and sums to check every parser read the same values
+struct ParseTotals {
+    long long records;
+    long long light_sum;
+    long long cars_sum;
+};
+
+//Parses with getline and a stringstream per line, as the simulators originally did
+ParseTotals parseWithStream(const char* path) {
+    ParseTotals totals = {0, 0, 0};
+    ifstream in(path);
+    string line;
+    while (getline(in, line)) {
+        string date, time, lid_str, cars_str;
+        stringstream ss(line);
+        if (ss >> date >> time >> lid_str >> cars_str) {
+            string hour = date + " " + time.substr(0,2);
+            totals.records++;
+            totals.light_sum += stoi(lid_str);
+            totals.cars_sum += stoi(cars_str);
+        }
+    }
+    return totals;
+}
+
+//Parses the mapped file with the string_view field splitter and from_chars
+ParseTotals parseWithFields(const mappedFile& file) {
+    ParseTotals totals = {0, 0, 0};
+    const char* position = file.data;
+    const char* data_end = file.data + file.size;
+    string_view line, date, time;
+    int light, cars;
+    while (nextLine(position, data_end, line)) {
+        if (parseTrafficLine(line, date, time, light, cars)) {
+            totals.records++;
+            totals.light_sum += light;
+            totals.cars_sum += cars;
+        }
+    }
+    return totals;
+}
+
+//Parses the mapped file with the SIMD record parser, timestamps included
+ParseTotals parseWithRecords(const mappedFile& file) {
+    ParseTotals totals = {0, 0, 0};
+    const char* position = file.data;
+    const char* data_end = file.data + file.size;
+    trafficRecord record;
+    long long minute_sum = 0;
+    while (nextTrafficRecord(position, data_end, record)) {
+        totals.records++;
+        totals.light_sum += record.light;
+        totals.cars_sum += record.cars;
+        minute_sum += record.minute;
+    }
+    //Keeps the timestamp conversion from being optimised away
+    if (minute_sum == -1) cout << minute_sum << endl;
+    return totals;
+}
+
+//Main function
+int main() {
+    const int runs = 10;
+
+    mappedFile in;
+    if (!openMappedFile(in, "data.txt")) {
+        cout << "Error opening data.txt" << endl;
+        return 1;
+    }
+
+    std::ofstream out("ParseBenchmarkResults.md");
+    if (!out) {
+        cout << "Error opening ParseBenchmarkResults.md" << endl;
+        return 1;
+    }
+
+    const char* names[] = {"getline + stringstream", "string_view fields + from_chars", "SIMD record parser"};
+    long long totals_time[3] = {0, 0, 0};
+    ParseTotals results[3];
+
+    for (int run = 0; run < runs; ++run) {
+        for (int parser = 0; parser < 3; ++parser) {
+            auto start = chrono::high_resolution_clock::now();
+            if (parser == 0) results[parser] = parseWithStream("data.txt");
+            else if (parser == 1) results[parser] = parseWithFields(in);
+            else results[parser] = parseWithRecords(in);
+            auto end = chrono::high_resolution_clock::now();
+            totals_time[parser] += chrono::duration_cast<chrono::microseconds>(end - start).count();
+        }
+    }
+
+    //Write table
+    out << "# Parse Benchmark Results\n";
+    out << "**Input:** data.txt, " << formatWithCommas(results[0].records) << " records, "
+        << formatWithCommas(in.size) << " bytes, average of " << runs << " runs\n\n";
+    out << "| Parser | Avg Time (microseconds) | Throughput (GB/s) |\n";
+    out << "|---|---|---|\n";
+    for (int parser = 0; parser < 3; ++parser) {
+        long long avg = totals_time[parser] / runs;
+        double throughput = (avg > 0) ? (double)in.size / avg / 1000.0 : 0.0;
+        out << "| " << names[parser] << " | " << formatWithCommas(avg) << " | " << fixed << setprecision(2) << throughput << " |\n";
+        cout << names[parser] << ": " << formatWithCommas(avg) << " microseconds, " << fixed << setprecision(2) << throughput << " GB/s" << endl;
+
+        if (results[parser].records != results[0].records || results[parser].light_sum != results[0].light_sum
+            || results[parser].cars_sum != results[0].cars_sum) {
+            out << "\n" << names[parser] << " did not read the same records as getline + stringstream\n";
+            cout << "  Did not read the same records as getline + stringstream" << endl;
+        }
+    }
+
+    out.close();
+    closeMappedFile(in);
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <omp.h>
+#include <chrono>
+#include "RingBuffer.h"
+
+using namespace std;
+
+//Formats number with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Construct to hold traffic data, the timestamp is a minute index
+struct TrafficData {
+    int minute;
+    int light_id;
+    int cars;
+};
+
+//Passes items values through the original queue (mutex and two condition variables), returns the sum consumed
+long long transferWithMutexQueue(int producers, int consumers, int buffer_size, long long items) {
+    queue<TrafficData> buffer;
+    mutex mtx;
+    condition_variable cv_full, cv_empty;
+    atomic<long long> next_item(0);
+    atomic<int> active_producers(producers);
+    atomic<long long> consumed_sum(0);
+
+    #pragma omp parallel num_threads(producers + consumers)
+    {
+        int tid = omp_get_thread_num();
+        if (tid < producers) {
+            while (true) {
+                long long idx = next_item++;
+                if (idx >= items) break;
+                TrafficData data = {(int)(idx / 1000), (int)(idx % 1000), (int)(idx % 101)};
+                unique_lock<mutex> lock(mtx);
+                cv_full.wait(lock, [&]() { return (int)buffer.size() < buffer_size; });
+                buffer.push(data);
+                cv_empty.notify_one();
+            }
+            {
+                lock_guard<mutex> lock(mtx);
+                active_producers--;
+            }
+            cv_empty.notify_all();
+        } else {
+            long long sum = 0;
+            while (true) {
+                TrafficData data;
+                {
+                    unique_lock<mutex> lock(mtx);
+                    cv_empty.wait(lock, [&]() { return !buffer.empty() || active_producers == 0; });
+                    if (buffer.empty() && active_producers == 0) break;
+                    data = buffer.front();
+                    buffer.pop();
+                    cv_full.notify_one();
+                }
+                sum += data.cars;
+            }
+            consumed_sum += sum;
+        }
+    }
+    return consumed_sum;
+}
+
+//Passes items values through the lock-free ring buffer, returns the sum consumed
+long long transferWithRingBuffer(int producers, int consumers, int buffer_size, long long items) {
+    ringBuffer<TrafficData> buffer;
+    initRingBuffer(buffer, buffer_size);
+    atomic<long long> next_item(0);
+    atomic<int> active_producers(producers);
+    atomic<long long> consumed_sum(0);
+
+    #pragma omp parallel num_threads(producers + consumers)
+    {
+        int tid = omp_get_thread_num();
+        if (tid < producers) {
+            while (true) {
+                long long idx = next_item++;
+                if (idx >= items) break;
+                TrafficData data = {(int)(idx / 1000), (int)(idx % 1000), (int)(idx % 101)};
+                ringPush(buffer, data);
+            }
+            if (--active_producers == 0) ringClose(buffer);
+        } else {
+            long long sum = 0;
+            TrafficData data;
+            while (ringPop(buffer, data)) {
+                sum += data.cars;
+            }
+            consumed_sum += sum;
+        }
+    }
+    return consumed_sum;
+}
+
+//Main function
+//The same number of items is passed from producers to consumers through both queues, for the thread counts and
+//buffer sizes of TrafficSimulatorCombined (threads producers and threads consumers). The consumers only add up the
+//values, so the time is the queue's own.
+int main() {
+    const long long items = 200000;
+    const int runs = 3;
+    vector<int> thread_counts = {2, 5, 10, 50, 100};
+    vector<int> buffer_sizes = {2, 10, 50, 100, 1000};
+
+    long long expected = 0;
+    for (long long idx = 0; idx < items; idx++) expected += idx % 101;
+
+    std::ofstream out("QueueBenchmarkResults.md");
+    if (!out) {
+        cout << "Error opening QueueBenchmarkResults.md" << endl;
+        return 1;
+    }
+
+    out << "# Queue Benchmark Results\n";
+    out << "**Items:** " << formatWithCommas(items) << ", average of " << runs << " runs, cells are mutex queue / ring buffer in microseconds\n\n";
+    out << "| Thread Count ";
+    for (int buf : buffer_sizes) out << "| Buffer Size " << buf << " ";
+    out << "|\n";
+    out << "|---";
+    for (size_t i = 0; i < buffer_sizes.size(); ++i) out << "|---";
+    out << "|\n";
+
+    bool correct = true;
+    for (int threads : thread_counts) {
+        out << "| " << threads << " ";
+        for (int buf : buffer_sizes) {
+            long long mutex_total = 0, ring_total = 0;
+            for (int run = 0; run < runs; ++run) {
+                auto start = chrono::high_resolution_clock::now();
+                long long mutex_sum = transferWithMutexQueue(threads, threads, buf, items);
+                auto end = chrono::high_resolution_clock::now();
+                mutex_total += chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+                start = chrono::high_resolution_clock::now();
+                long long ring_sum = transferWithRingBuffer(threads, threads, buf, items);
+                end = chrono::high_resolution_clock::now();
+                ring_total += chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+                //Checked after both transfers, so a failure doesn't stop the remaining cells from being measured
+                if (mutex_sum != expected || ring_sum != expected) correct = false;
+            }
+            out << "| " << formatWithCommas(mutex_total / runs) << " / " << formatWithCommas(ring_total / runs) << " ";
+            cout << "Threads " << threads << ", buffer " << buf << ": mutex queue " << formatWithCommas(mutex_total / runs)
+                 << " us, ring buffer " << formatWithCommas(ring_total / runs) << " us" << endl;
+        }
+        out << "|\n";
+    }
+
+    if (!correct) {
+        out << "\nA queue lost or duplicated items\n";
+        cout << "A queue lost or duplicated items" << endl;
+    }
+    out.close();
+    return correct ? 0 : 1;
+}
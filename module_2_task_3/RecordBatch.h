@@ -0,0 +1,94 @@
+#ifndef RECORD_BATCH_H
+#define RECORD_BATCH_H
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include "RingBuffer.h"
+
+//Batched hand-off between producers and consumers.
+//Instead of one ring operation (and one results lock) per record, a producer fills a fixed-capacity batch of records
+//and queues the whole batch, and a consumer adds up a whole batch under one lock. The batches are allocated once and
+//passed around by index: a producer takes an empty one from the free list, and the consumer that drained it puts it
+//back. Both the free list and the queue of full batches are ring buffers of batch indices.
+
+//STRUCTURE SECTION -------------------------------------------------------------------------
+
+//Structure to hold one batch of up to the pool's batch size records
+template <typename T>
+struct recordBatch {
+    std::unique_ptr<T[]> records;
+    size_t count = 0;
+};
+
+//Structure to hold every batch, the free list and the queue of full batches
+template <typename T>
+struct batchPool {
+    std::vector<recordBatch<T>> batches;
+    size_t batch_size = 1;
+    ringBuffer<int> free_batches;
+    ringBuffer<int> full_batches;
+};
+
+//POOL SECTION ------------------------------------------------------------------------------
+
+//Function to allocate the batches of a pool
+//buffer_size is in records, as for the per-record ring, so at most buffer_size / batch_size batches (at least one)
+//are queued. One more batch per thread lets every producer fill and every consumer drain while the queue is full,
+//so taking a free batch never waits.
+template <typename T>
+inline void initBatchPool(batchPool<T>& pool, size_t batch_size, size_t buffer_size, int threads) {
+    pool.batch_size = (batch_size < 1) ? 1 : batch_size;
+    size_t queued = buffer_size / pool.batch_size;
+    if (queued < 1) queued = 1;
+    size_t total = queued + ((threads > 0) ? threads : 0);
+
+    pool.batches.clear();
+    pool.batches.resize(total);
+    for (recordBatch<T>& batch : pool.batches) {
+        batch.records.reset(new T[pool.batch_size]);
+        batch.count = 0;
+    }
+    initRingBuffer(pool.free_batches, total);
+    initRingBuffer(pool.full_batches, queued);
+    for (size_t i = 0; i < total; i++) {
+        ringTryPush(pool.free_batches, (int)i);
+    }
+}
+
+//Function to take an empty batch from the free list, returns its index
+template <typename T>
+inline int acquireBatch(batchPool<T>& pool) {
+    int index = 0;
+    ringPop(pool.free_batches, index);
+    pool.batches[index].count = 0;
+    return index;
+}
+
+//Function to queue a filled batch for the consumers, waiting while the queue is full
+template <typename T>
+inline void submitBatch(batchPool<T>& pool, int index) {
+    ringPush(pool.full_batches, index);
+}
+
+//Function to take the oldest full batch, waiting while there is none
+//Returns -1 once the pool is closed and every batch has been taken.
+template <typename T>
+inline int receiveBatch(batchPool<T>& pool) {
+    int index;
+    return ringPop(pool.full_batches, index) ? index : -1;
+}
+
+//Function to return a drained (or unused) batch to the free list
+template <typename T>
+inline void releaseBatch(batchPool<T>& pool, int index) {
+    ringPush(pool.free_batches, index);
+}
+
+//Function to mark that no more batches will be queued, called by the last producer
+template <typename T>
+inline void closeBatchPool(batchPool<T>& pool) {
+    ringClose(pool.full_batches);
+}
+
+#endif
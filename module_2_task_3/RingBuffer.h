@@ -0,0 +1,192 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+//Lock-free bounded multi-producer multi-consumer ring buffer, replacing the queue guarded by a mutex and two
+//condition variables.
+//Every slot carries a sequence number that says whose turn it is:
+//  sequence == 2 * position      the slot is free for the producer that claims enqueue position `position`
+//  sequence == 2 * position + 1  the slot holds the value for the consumer that claims dequeue position `position`
+//A producer claims a position with a compare-and-swap on the enqueue position, writes its value and publishes it by
+//storing 2 * position + 1; a consumer does the same on the dequeue position and frees the slot for the next lap by
+//storing 2 * (position + capacity). Doubling keeps "full" and "free for the next lap" apart even with one slot. No lock is taken on either path, and the two positions sit on their own cache lines so
+//producers and consumers don't invalidate each other's.
+//A thread that finds the ring full (or empty) spins for a while, then yields, and only then parks on a condition
+//variable. The side that makes progress only takes the lock to wake someone when a thread is actually parked.
+
+//CONFIGURATION SECTION ---------------------------------------------------------------------
+
+const int CACHE_LINE_BYTES = 64;
+
+//Failed attempts spent spinning and then yielding before a thread parks
+const int RING_SPIN_LIMIT = 64;
+const int RING_YIELD_LIMIT = 16;
+
+//STRUCTURE SECTION -------------------------------------------------------------------------
+
+//Structure to hold one slot, on its own cache line
+template <typename T>
+struct alignas(CACHE_LINE_BYTES) ringSlot {
+    std::atomic<size_t> sequence;
+    T value;
+};
+
+//Structure to hold the threads parked waiting for one condition (not full, or not empty)
+//epoch changes every time they are woken, so a thread that re-checked the ring before an epoch change can't miss it.
+struct ringParking {
+    std::mutex lock;
+    std::condition_variable wake;
+    std::atomic<int> sleepers{0};
+    std::atomic<unsigned> epoch{0};
+};
+
+//Structure to hold the ring buffer
+template <typename T>
+struct ringBuffer {
+    alignas(CACHE_LINE_BYTES) std::atomic<size_t> enqueue_position{0};
+    alignas(CACHE_LINE_BYTES) std::atomic<size_t> dequeue_position{0};
+    alignas(CACHE_LINE_BYTES) std::atomic<bool> closed{false};
+    std::unique_ptr<ringSlot<T>[]> slots;
+    size_t capacity = 0;
+    ringParking not_full;
+    ringParking not_empty;
+};
+
+//Function to give an empty ring room for capacity values (at least 1)
+template <typename T>
+inline void initRingBuffer(ringBuffer<T>& ring, size_t capacity) {
+    ring.capacity = (capacity < 1) ? 1 : capacity;
+    ring.slots.reset(new ringSlot<T>[ring.capacity]);
+    for (size_t i = 0; i < ring.capacity; i++) {
+        ring.slots[i].sequence.store(2 * i, std::memory_order_relaxed);
+    }
+    ring.enqueue_position.store(0, std::memory_order_relaxed);
+    ring.dequeue_position.store(0, std::memory_order_relaxed);
+    ring.closed.store(false, std::memory_order_release);
+}
+
+//WAITING SECTION ---------------------------------------------------------------------------
+
+//Function to wake every thread parked on parking, called after the ring changed
+inline void wakeParked(ringParking& parking) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parking.sleepers.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> guard(parking.lock);
+        parking.epoch.fetch_add(1, std::memory_order_relaxed);
+        parking.wake.notify_all();
+    }
+}
+
+//Function to wait until attempt() succeeds or done() is true, spinning, then yielding, then parking
+//Returns true if attempt() succeeded.
+template <typename Attempt, typename Done>
+inline bool waitFor(ringParking& parking, Attempt attempt, Done done) {
+    for (int tries = 0; ; tries++) {
+        if (attempt()) return true;
+        if (done()) return attempt();
+
+        if (tries < RING_SPIN_LIMIT) {
+#if defined(__SSE2__)
+            _mm_pause();
+#endif
+        } else if (tries < RING_SPIN_LIMIT + RING_YIELD_LIMIT) {
+            std::this_thread::yield();
+        } else {
+            //Registered as a sleeper before the last check, so a change after it is sure to bump the epoch
+            unsigned epoch = parking.epoch.load(std::memory_order_relaxed);
+            parking.sleepers.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (attempt()) {
+                parking.sleepers.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (!done()) {
+                std::unique_lock<std::mutex> guard(parking.lock);
+                parking.wake.wait(guard, [&]() { return parking.epoch.load(std::memory_order_relaxed) != epoch; });
+            }
+            parking.sleepers.fetch_sub(1, std::memory_order_relaxed);
+            tries = 0;
+        }
+    }
+}
+
+//OPERATION SECTION -------------------------------------------------------------------------
+
+//Function to add value to the ring if it isn't full, returns false if it is
+template <typename T>
+inline bool ringTryPush(ringBuffer<T>& ring, const T& value) {
+    size_t position = ring.enqueue_position.load(std::memory_order_relaxed);
+    while (true) {
+        ringSlot<T>& slot = ring.slots[position % ring.capacity];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == 2 * position) {
+            if (ring.enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.value = value;
+                slot.sequence.store(2 * position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (sequence < 2 * position) {
+            //The slot still holds the value from the previous lap: full
+            return false;
+        } else {
+            position = ring.enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//Function to take the oldest value from the ring if it isn't empty, returns false if it is
+template <typename T>
+inline bool ringTryPop(ringBuffer<T>& ring, T& value) {
+    size_t position = ring.dequeue_position.load(std::memory_order_relaxed);
+    while (true) {
+        ringSlot<T>& slot = ring.slots[position % ring.capacity];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == 2 * position + 1) {
+            if (ring.dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                value = slot.value;
+                slot.sequence.store(2 * (position + ring.capacity), std::memory_order_release);
+                return true;
+            }
+        } else if (sequence < 2 * position + 1) {
+            //Nothing has been published at this position yet: empty
+            return false;
+        } else {
+            position = ring.dequeue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//Function to add value to the ring, waiting while it is full
+template <typename T>
+inline void ringPush(ringBuffer<T>& ring, const T& value) {
+    waitFor(ring.not_full, [&]() { return ringTryPush(ring, value); }, []() { return false; });
+    wakeParked(ring.not_empty);
+}
+
+//Function to take the oldest value from the ring, waiting while it is empty
+//Returns false once the ring is closed and every value has been taken.
+template <typename T>
+inline bool ringPop(ringBuffer<T>& ring, T& value) {
+    bool popped = waitFor(ring.not_empty, [&]() { return ringTryPop(ring, value); },
+                          [&]() { return ring.closed.load(std::memory_order_acquire); });
+    if (popped) wakeParked(ring.not_full);
+    return popped;
+}
+
+//Function to mark that no more values will be pushed, waking the consumers so they can drain the ring and stop
+template <typename T>
+inline void ringClose(ringBuffer<T>& ring) {
+    ring.closed.store(true, std::memory_order_release);
+    wakeParked(ring.not_empty);
+}
+
+#endif
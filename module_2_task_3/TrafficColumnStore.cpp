@@ -0,0 +1,197 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "TrafficColumns.h"
+
+using namespace std;
+
+//Formats number with commas
+string formatWithCommas(long long number)
+{
+    string str = to_string(number);
+    string result = "";
+    int count = 0;
+
+    for (int i = str.length() - 1; i >= 0; i--)
+    {
+        if (count == 3)
+        {
+            result = "," + result;
+            count = 0;
+        }
+        result = str[i] + result;
+        count++;
+    }
+
+    return result;
+}
+
+//Prints how to run the program
+void printUsage() {
+    cout << "Usage:" << endl;
+    cout << "  TrafficColumnStore build [input (data.txt or data.bin)] [store (data.col)]" << endl;
+    cout << "  TrafficColumnStore query [store (data.col)] [N] [from=YYYY-MM-DD] [to=YYYY-MM-DD] [lights=1,2,3]" << endl;
+}
+
+//Parses a YYYY-MM-DD date into the minute index of its midnight
+bool parseDateMinute(const string& text, int& minute) {
+    return text.size() == 10 && parseTimestampMinute(text.c_str(), "00:00:00", minute);
+}
+
+//Parses a comma separated list of light IDs
+bool parseLights(const string& text, vector<int>& lights) {
+    string_view rest(text);
+    while (!rest.empty()) {
+        size_t comma = rest.find(',');
+        int light;
+        if (!parseInt(rest.substr(0, comma), light)) return false;
+        lights.push_back(light);
+        rest = (comma == string_view::npos) ? string_view() : rest.substr(comma + 1);
+    }
+    return !lights.empty();
+}
+
+//Converts a text or binary input file into a column store
+int buildStore(const char* input_path, const char* store_path) {
+    auto start = chrono::high_resolution_clock::now();
+
+    trafficInput in;
+    if (!openTrafficInput(in, input_path, false)) {
+        cout << "Error opening " << input_path << endl;
+        return 1;
+    }
+    columnWriter writer;
+    if (!openColumnWriter(writer, store_path)) {
+        cout << "Error opening " << store_path << endl;
+        closeTrafficInput(in);
+        return 1;
+    }
+
+    scanTrafficRecords(in, [&](const trafficRecord& record) {
+        appendColumnRecord(writer, record);
+    });
+    size_t input_size = in.file.size;
+    closeTrafficInput(in);
+    if (!closeColumnWriter(writer)) {
+        cout << "Error writing " << store_path << endl;
+        return 1;
+    }
+
+    auto end = chrono::high_resolution_clock::now();
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    uint64_t store_size = writer.offset + writer.blocks.size() * sizeof(columnBlock);
+    cout << "Stored " << formatWithCommas(writer.records) << " records from " << input_path << " in " << store_path
+         << " (" << formatWithCommas(writer.blocks.size()) << " blocks)" << endl;
+    cout << formatWithCommas(input_size) << " bytes of input became " << formatWithCommas(store_size) << " bytes" << endl;
+    cout << "Processing time: " << formatWithCommas(elapsed.count()) << " microseconds" << endl;
+    return 0;
+}
+
+//Answers the top N congested lights per hour over the records matching the query
+int queryStore(const char* store_path, int N, const columnQuery& query) {
+    std::ofstream out("TrafficColumnStoreResults.txt");
+    if (!out) {
+        cout << "Error opening TrafficColumnStoreResults.txt" << endl;
+        return 1;
+    }
+
+    //Start timing
+    auto start = chrono::high_resolution_clock::now();
+
+    columnStore store;
+    if (!openColumnStore(store, store_path)) {
+        out << "Error opening " << store_path << endl;
+        return 1;
+    }
+
+    //Cars per light for each hour, dense over the ranges of the blocks the query reads
+    hourLightTable hour_to_light;
+    hourLightRanges ranges{};
+    if (columnStoreRanges(store, query, ranges)) {
+        initHourLightTable(hour_to_light, ranges);
+    } else {
+        initHourLightTable(hour_to_light);
+    }
+    columnScanStats stats = scanColumnStore(store, query, [&](const trafficRecord& record) {
+        addCars(hour_to_light, record.minute / 60, record.light, record.cars);
+    });
+    closeColumnStore(store);
+
+    //Stop timing
+    auto end = chrono::high_resolution_clock::now();
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    //Output results
+    forEachHour(hour_to_light, [&](int hour_index, vector<pair<long long, int>>& vec) {
+        string hour = formatHour(hour_index);
+        sort(vec.rbegin(), vec.rend());
+
+        out << "Top " << N << " congested lights for hour " << hour << ":" << endl;
+        for (int i = 0; i < min(N, (int)vec.size()); i++) {
+            out << "  Light " << vec[i].second << ": " << vec[i].first << " cars" << endl;
+        }
+        out << endl;
+    });
+
+    out << "Blocks scanned: " << formatWithCommas(stats.blocks_scanned) << ", skipped: " << formatWithCommas(stats.blocks_skipped)
+        << ", records matched: " << formatWithCommas(stats.records) << endl;
+    out << "Processing time: " << formatWithCommas(elapsed.count()) << " microseconds" << endl;
+    out.close();
+
+    cout << "Blocks scanned: " << formatWithCommas(stats.blocks_scanned) << ", skipped: " << formatWithCommas(stats.blocks_skipped)
+         << ", records matched: " << formatWithCommas(stats.records) << endl;
+    cout << "Processing time: " << formatWithCommas(elapsed.count()) << " microseconds" << endl;
+    cout << "Results written to TrafficColumnStoreResults.txt" << endl;
+    return 0;
+}
+
+//Main function
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    string mode = argv[1];
+
+    if (mode == "build") {
+        return buildStore((argc > 2) ? argv[2] : "data.txt", (argc > 3) ? argv[3] : "data.col");
+    }
+
+    if (mode == "query") {
+        const char* store_path = (argc > 2) ? argv[2] : "data.col";
+        int N = 5;
+        if (argc > 3 && !parseInt(argv[3], N)) {
+            printUsage();
+            return 1;
+        }
+
+        //Whole store unless restricted, to= includes the whole day
+        columnQuery query = {0, 2147483647, {}};
+        for (int i = 4; i < argc; i++) {
+            string option = argv[i];
+            bool valid = false;
+            if (option.rfind("from=", 0) == 0) {
+                valid = parseDateMinute(option.substr(5), query.first_minute);
+            } else if (option.rfind("to=", 0) == 0) {
+                valid = parseDateMinute(option.substr(3), query.last_minute);
+                query.last_minute += 24 * 60 - 1;
+            } else if (option.rfind("lights=", 0) == 0) {
+                valid = parseLights(option.substr(7), query.lights);
+            }
+            if (!valid) {
+                cout << "Invalid option: " << option << endl;
+                printUsage();
+                return 1;
+            }
+        }
+        return queryStore(store_path, N, query);
+    }
+
+    printUsage();
+    return 1;
+}
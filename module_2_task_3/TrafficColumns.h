@@ -0,0 +1,433 @@
+#ifndef TRAFFIC_COLUMNS_H
+#define TRAFFIC_COLUMNS_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include "TrafficInput.h"
+
+//Columnar, block-compressed store for long traffic datasets.
+//Records are buffered one day at a time and sorted by (light, minute) before being cut into blocks of
+//COLUMN_BLOCK_RECORDS, so a block covers a narrow time range and a narrow range of lights. Every block keeps its
+//minute, light and car columns separately, each encoded as whichever is narrower of:
+//  frame of reference: value - block minimum
+//  delta: zigzag(value - previous value), which is what makes a light's 5 minute steps a few bits wide
+//and bit-packed at that width. The directory at the end of the file keeps a zone map (min/max of every column) per
+//block, so a query restricted to a time range or to some lights skips the blocks it can't match without reading them.
+//Values are packed vertically in PACK_LANES lanes (value i goes to lane i % PACK_LANES), so unpacking does the same
+//shift and mask on all the lanes at once with SIMD instructions.
+
+//CONFIGURATION SECTION ---------------------------------------------------------------------
+
+const int COLUMN_BLOCK_RECORDS = 4096;
+const int PACK_LANES = 8;
+const int PACK_GROUP = PACK_LANES * 32;
+const int COLUMN_COUNT = 3;
+
+const char COLUMN_MAGIC[4] = {'T', 'C', 'O', 'L'};
+const uint32_t COLUMN_VERSION = 1;
+
+//FORMAT SECTION ----------------------------------------------------------------------------
+
+//Structure to hold the header of a column store file
+struct columnHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t records;
+    uint64_t blocks;
+    uint64_t directory_offset;
+};
+
+//Structure to hold how one column of a block is encoded
+struct columnEncoding {
+    int32_t base;
+    uint8_t width;
+    uint8_t delta;
+    uint16_t unused;
+};
+
+//Structure to hold a directory entry: where a block is, its zone map and its column encodings
+struct columnBlock {
+    uint64_t offset;
+    uint32_t count;
+    int32_t min_minute, max_minute;
+    int32_t min_light, max_light;
+    int32_t min_cars, max_cars;
+    columnEncoding columns[COLUMN_COUNT];
+};
+
+//Function to return the number of 32 bit words a column of count values packed at width takes
+inline size_t packedWords(int count, int width) {
+    return (size_t)((count + PACK_GROUP - 1) / PACK_GROUP) * width * PACK_LANES;
+}
+
+//PACKING SECTION ---------------------------------------------------------------------------
+
+//Function to return the number of bits needed to hold value
+inline int bitWidth(uint32_t value) {
+    return (value == 0) ? 0 : 32 - __builtin_clz(value);
+}
+
+//Function to zigzag-encode a signed delta, so small negative and positive deltas both become small codes
+inline uint64_t zigzagEncode(int64_t delta) {
+    return ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+}
+
+//Function to undo zigzagEncode
+inline int32_t zigzagDecode(uint32_t code) {
+    return (int32_t)(code >> 1) ^ -(int32_t)(code & 1);
+}
+
+//Function to pack count codes at width bits into words (packedWords(count, width) words, zeroed by the caller)
+inline void packCodes(const uint32_t codes[], int count, int width, uint32_t words[]) {
+    if (width == 0) return;
+    for (int i = 0; i < count; i++) {
+        int group = i / PACK_GROUP;
+        int lane = i % PACK_LANES;
+        int bit = ((i % PACK_GROUP) / PACK_LANES) * width;
+        uint32_t* lane_words = words + (size_t)group * width * PACK_LANES + lane;
+        lane_words[(bit / 32) * PACK_LANES] |= codes[i] << (bit % 32);
+        if (bit % 32 + width > 32) {
+            lane_words[(bit / 32 + 1) * PACK_LANES] |= codes[i] >> (32 - bit % 32);
+        }
+    }
+}
+
+//Function to unpack count codes of width bits from words
+//Every value of a group row sits at the same bit position in its lane, so a row is unpacked with the same shift and
+//mask over PACK_LANES consecutive words (two SSE2 registers).
+inline void unpackCodes(const uint32_t words[], int count, int width, uint32_t codes[]) {
+    if (width == 0) {
+        std::fill(codes, codes + count, 0u);
+        return;
+    }
+    uint32_t mask = (width == 32) ? 0xFFFFFFFFu : ((1u << width) - 1);
+    int groups = (count + PACK_GROUP - 1) / PACK_GROUP;
+    for (int group = 0; group < groups; group++) {
+        const uint32_t* group_words = words + (size_t)group * width * PACK_LANES;
+        uint32_t* group_codes = codes + group * PACK_GROUP;
+        for (int row = 0; row < 32; row++) {
+            int bit = row * width;
+            const uint32_t* low = group_words + (bit / 32) * PACK_LANES;
+            const uint32_t* high = low + PACK_LANES;
+            int shift = bit % 32;
+            bool spans = shift + width > 32;
+            uint32_t* row_codes = group_codes + row * PACK_LANES;
+#if defined(__SSE2__)
+            __m128i right = _mm_cvtsi32_si128(shift);
+            __m128i left = _mm_cvtsi32_si128(32 - shift);
+            __m128i lane_mask = _mm_set1_epi32((int)mask);
+            for (int lane = 0; lane < PACK_LANES; lane += 4) {
+                __m128i value = _mm_srl_epi32(_mm_loadu_si128((const __m128i*)(low + lane)), right);
+                if (spans) {
+                    value = _mm_or_si128(value, _mm_sll_epi32(_mm_loadu_si128((const __m128i*)(high + lane)), left));
+                }
+                _mm_storeu_si128((__m128i*)(row_codes + lane), _mm_and_si128(value, lane_mask));
+            }
+#else
+            for (int lane = 0; lane < PACK_LANES; lane++) {
+                uint32_t value = low[lane] >> shift;
+                if (spans) value |= high[lane] << (32 - shift);
+                row_codes[lane] = value & mask;
+            }
+#endif
+        }
+    }
+}
+
+//Function to pick the narrower encoding of a column and compute its codes
+inline columnEncoding encodeColumn(const int32_t values[], int count, uint32_t codes[]) {
+    int32_t min_value = *std::min_element(values, values + count);
+    int32_t max_value = *std::max_element(values, values + count);
+    int for_width = bitWidth((uint32_t)((int64_t)max_value - min_value));
+
+    //Deltas that don't fit in 32 bits rule the delta encoding out
+    uint64_t delta_bits = 0;
+    for (int i = 1; i < count; i++) {
+        delta_bits |= zigzagEncode((int64_t)values[i] - values[i - 1]);
+    }
+    int delta_width = (delta_bits > 0xFFFFFFFFu) ? 33 : bitWidth((uint32_t)delta_bits);
+
+    columnEncoding encoding = {0, 0, 0, 0};
+    if (delta_width < for_width) {
+        encoding.base = values[0];
+        encoding.width = (uint8_t)delta_width;
+        encoding.delta = 1;
+        codes[0] = 0;
+        for (int i = 1; i < count; i++) {
+            codes[i] = (uint32_t)zigzagEncode((int64_t)values[i] - values[i - 1]);
+        }
+    } else {
+        encoding.base = min_value;
+        encoding.width = (uint8_t)for_width;
+        for (int i = 0; i < count; i++) {
+            codes[i] = (uint32_t)((int64_t)values[i] - min_value);
+        }
+    }
+    return encoding;
+}
+
+//Function to decode a column of count values from its packed words
+inline void decodeColumn(const uint32_t words[], int count, const columnEncoding& encoding, uint32_t codes[], int32_t values[]) {
+    unpackCodes(words, count, encoding.width, codes);
+    if (encoding.delta) {
+        int32_t value = encoding.base;
+        for (int i = 0; i < count; i++) {
+            value += zigzagDecode(codes[i]);
+            values[i] = value;
+        }
+    } else {
+        for (int i = 0; i < count; i++) {
+            values[i] = (int32_t)(encoding.base + codes[i]);
+        }
+    }
+}
+
+//WRITE SECTION -----------------------------------------------------------------------------
+
+//Structure to hold a column store being written
+struct columnWriter {
+    std::ofstream out;
+    std::vector<columnBlock> blocks;
+    std::vector<trafficRecord> partition;
+    int partition_day;
+    uint64_t records;
+    uint64_t offset;
+};
+
+//Function to write the header of a column store file at the current position of out
+inline void writeColumnHeader(std::ofstream& out, uint64_t records, uint64_t blocks, uint64_t directory_offset) {
+    columnHeader header;
+    memcpy(header.magic, COLUMN_MAGIC, sizeof(header.magic));
+    header.version = COLUMN_VERSION;
+    header.records = records;
+    header.blocks = blocks;
+    header.directory_offset = directory_offset;
+    out.write((const char*)&header, sizeof(header));
+}
+
+//Function to start writing a column store at path, returns false if it can't be created
+inline bool openColumnWriter(columnWriter& writer, const char* path) {
+    writer.out.open(path, std::ios::binary);
+    if (!writer.out) return false;
+    writer.blocks.clear();
+    writer.partition.clear();
+    writer.partition_day = -1;
+    writer.records = 0;
+    writer.offset = sizeof(columnHeader);
+    writeColumnHeader(writer.out, 0, 0, 0);
+    return true;
+}
+
+//Function to encode and write one block of count records
+inline void writeColumnBlock(columnWriter& writer, const trafficRecord records[], int count) {
+    int32_t values[COLUMN_COUNT][COLUMN_BLOCK_RECORDS];
+    uint32_t codes[COLUMN_BLOCK_RECORDS];
+    for (int i = 0; i < count; i++) {
+        values[0][i] = records[i].minute;
+        values[1][i] = records[i].light;
+        values[2][i] = records[i].cars;
+    }
+
+    //Zeroed first so the padding and unused fields written to the directory are the same every time
+    columnBlock block;
+    memset(&block, 0, sizeof(block));
+    block.offset = writer.offset;
+    block.count = (uint32_t)count;
+    int32_t* zone[COLUMN_COUNT][2] = {{&block.min_minute, &block.max_minute}, {&block.min_light, &block.max_light},
+                                      {&block.min_cars, &block.max_cars}};
+    for (int column = 0; column < COLUMN_COUNT; column++) {
+        *zone[column][0] = *std::min_element(values[column], values[column] + count);
+        *zone[column][1] = *std::max_element(values[column], values[column] + count);
+        block.columns[column] = encodeColumn(values[column], count, codes);
+
+        std::vector<uint32_t> words(packedWords(count, block.columns[column].width), 0u);
+        packCodes(codes, count, block.columns[column].width, words.data());
+        writer.out.write((const char*)words.data(), words.size() * sizeof(uint32_t));
+        writer.offset += words.size() * sizeof(uint32_t);
+    }
+    writer.blocks.push_back(block);
+    writer.records += count;
+}
+
+//Function to sort the buffered day by (light, minute) and write it as blocks
+inline void flushColumnPartition(columnWriter& writer) {
+    std::vector<trafficRecord>& partition = writer.partition;
+    std::sort(partition.begin(), partition.end(), [](const trafficRecord& a, const trafficRecord& b) {
+        return (a.light != b.light) ? a.light < b.light : a.minute < b.minute;
+    });
+    for (size_t start = 0; start < partition.size(); start += COLUMN_BLOCK_RECORDS) {
+        int count = (int)std::min(partition.size() - start, (size_t)COLUMN_BLOCK_RECORDS);
+        writeColumnBlock(writer, partition.data() + start, count);
+    }
+    partition.clear();
+}
+
+//Function to add a record to the store being written
+inline void appendColumnRecord(columnWriter& writer, const trafficRecord& record) {
+    int day = record.minute / (24 * 60);
+    if (day != writer.partition_day && !writer.partition.empty()) {
+        flushColumnPartition(writer);
+    }
+    writer.partition_day = day;
+    writer.partition.push_back(record);
+}
+
+//Function to write the last blocks, the directory and the final header, returns false if writing failed
+inline bool closeColumnWriter(columnWriter& writer) {
+    flushColumnPartition(writer);
+
+    //The directory is read in place from the mapping, so it starts 8 byte aligned
+    const char padding[8] = {0};
+    size_t pad = (size_t)((8 - writer.offset % 8) % 8);
+    writer.out.write(padding, pad);
+    uint64_t directory_offset = writer.offset + pad;
+    writer.out.write((const char*)writer.blocks.data(), writer.blocks.size() * sizeof(columnBlock));
+    writer.out.seekp(0);
+    writeColumnHeader(writer.out, writer.records, writer.blocks.size(), directory_offset);
+    writer.out.close();
+    return !writer.out.fail();
+}
+
+//READ SECTION ------------------------------------------------------------------------------
+
+//Structure to hold an opened column store
+struct columnStore {
+    mappedFile file;
+    const columnBlock* blocks;
+    long long block_count;
+    long long records;
+};
+
+//Function to open a column store, returns false if it can't be mapped or isn't a valid store
+inline bool openColumnStore(columnStore& store, const char* path) {
+    store.blocks = nullptr;
+    store.block_count = 0;
+    store.records = 0;
+    if (!openMappedFile(store.file, path)) return false;
+
+    columnHeader header;
+    bool valid = store.file.size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, store.file.data, sizeof(header));
+        valid = memcmp(header.magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) == 0 && header.version == COLUMN_VERSION
+             && header.directory_offset <= store.file.size
+             && (store.file.size - header.directory_offset) / sizeof(columnBlock) == header.blocks
+             && header.directory_offset % alignof(columnBlock) == 0;
+    }
+    if (!valid) {
+        closeMappedFile(store.file);
+        return false;
+    }
+    store.blocks = (const columnBlock*)(store.file.data + header.directory_offset);
+    store.block_count = (long long)header.blocks;
+    store.records = (long long)header.records;
+    return true;
+}
+
+//Function to unmap a column store
+inline void closeColumnStore(columnStore& store) {
+    closeMappedFile(store.file);
+    store.blocks = nullptr;
+    store.block_count = 0;
+    store.records = 0;
+}
+
+//QUERY SECTION -----------------------------------------------------------------------------
+
+//Structure to hold a query: a minute range (inclusive) and the lights to keep (all lights when empty)
+struct columnQuery {
+    int first_minute;
+    int last_minute;
+    std::vector<int> lights;
+};
+
+//Structure to hold what a scan read
+struct columnScanStats {
+    long long blocks_scanned;
+    long long blocks_skipped;
+    long long records;
+};
+
+//Function to check a block's zone map against a query (lights must be sorted)
+inline bool blockMatches(const columnBlock& block, const columnQuery& query) {
+    if (block.max_minute < query.first_minute || block.min_minute > query.last_minute) return false;
+    if (query.lights.empty()) return true;
+    auto light = std::lower_bound(query.lights.begin(), query.lights.end(), block.min_light);
+    return light != query.lights.end() && *light <= block.max_light;
+}
+
+//Function to find the hour and light ranges of the blocks a query reads from their zone maps, false if it reads none
+inline bool columnStoreRanges(const columnStore& store, columnQuery query, hourLightRanges& ranges) {
+    std::sort(query.lights.begin(), query.lights.end());
+    bool found = false;
+    for (long long b = 0; b < store.block_count; b++) {
+        const columnBlock& block = store.blocks[b];
+        if (!blockMatches(block, query)) continue;
+        hourLightRanges block_ranges = {block.min_minute / 60, block.max_minute / 60, block.min_light, block.max_light};
+        if (!found) {
+            ranges = block_ranges;
+            found = true;
+        } else {
+            ranges.first_hour = std::min(ranges.first_hour, block_ranges.first_hour);
+            ranges.last_hour = std::max(ranges.last_hour, block_ranges.last_hour);
+            ranges.first_light = std::min(ranges.first_light, block_ranges.first_light);
+            ranges.last_light = std::max(ranges.last_light, block_ranges.last_light);
+        }
+    }
+    return found;
+}
+
+//Function to call visit on every record of the store that matches the query
+//Blocks whose zone map can't match are skipped without being decoded.
+template <typename Visit>
+inline columnScanStats scanColumnStore(const columnStore& store, columnQuery query, Visit visit) {
+    std::sort(query.lights.begin(), query.lights.end());
+    std::vector<char> keep_light;
+    if (!query.lights.empty()) {
+        keep_light.assign(std::max(query.lights.back() + 1, 0), 0);
+        for (int light : query.lights) {
+            if (light >= 0) keep_light[light] = 1;
+        }
+    }
+
+    columnScanStats stats = {0, 0, 0};
+    std::vector<uint32_t> codes(COLUMN_BLOCK_RECORDS);
+    std::vector<int32_t> values[COLUMN_COUNT];
+    for (int column = 0; column < COLUMN_COUNT; column++) values[column].resize(COLUMN_BLOCK_RECORDS);
+
+    for (long long b = 0; b < store.block_count; b++) {
+        const columnBlock& block = store.blocks[b];
+        if (!blockMatches(block, query)) {
+            stats.blocks_skipped++;
+            continue;
+        }
+        stats.blocks_scanned++;
+
+        int count = (int)block.count;
+        const uint32_t* words = (const uint32_t*)(store.file.data + block.offset);
+        for (int column = 0; column < COLUMN_COUNT; column++) {
+            decodeColumn(words, count, block.columns[column], codes.data(), values[column].data());
+            words += packedWords(count, block.columns[column].width);
+        }
+
+        bool whole_block = block.min_minute >= query.first_minute && block.max_minute <= query.last_minute && query.lights.empty();
+        trafficRecord record;
+        for (int i = 0; i < count; i++) {
+            record.minute = values[0][i];
+            record.light = values[1][i];
+            record.cars = values[2][i];
+            if (!whole_block) {
+                if (record.minute < query.first_minute || record.minute > query.last_minute) continue;
+                if (!query.lights.empty() && (record.light < 0 || record.light >= (int)keep_light.size() || !keep_light[record.light])) continue;
+            }
+            stats.records++;
+            visit(record);
+        }
+    }
+    return stats;
+}
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef TRAFFIC_INPUT_H
+#define TRAFFIC_INPUT_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <vector>
+#include "TrafficParser.h"
+#include "TrafficTable.h"
+
+//Binary record format and the input reader shared by the simulators.
+//A binary file is a 16 byte header followed by fixed-width 10 byte records (little-endian, no padding):
+//  header: "TRAF", uint32 version, uint64 record count
+//  record: uint32 minute index (minutes since 1970-01-01), uint32 light ID, uint16 car count
+//A binary file is read by copying the fields out of the mapped records, with no parsing at all. The reader tells the
+//two formats apart by the header, so every simulator accepts either a text or a binary file.
+
+//FORMAT SECTION ----------------------------------------------------------------------------
+
+const char BINARY_MAGIC[4] = {'T', 'R', 'A', 'F'};
+const uint32_t BINARY_VERSION = 1;
+
+//Structure to hold the header of a binary file
+struct binaryHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t records;
+};
+
+#pragma pack(push, 1)
+//Structure to hold one binary record
+struct binaryRecord {
+    uint32_t minute;
+    uint32_t light;
+    uint16_t cars;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(binaryHeader) == 16, "binary header must be 16 bytes");
+static_assert(sizeof(binaryRecord) == 10, "binary record must be 10 bytes");
+
+//Largest car count a binary record can hold
+const int BINARY_MAX_CARS = 65535;
+
+//WRITE SECTION -----------------------------------------------------------------------------
+
+//Function to write the header of a binary file holding records records at the current position of out
+inline void writeBinaryHeader(std::ofstream& out, uint64_t records) {
+    binaryHeader header;
+    memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.records = records;
+    out.write((const char*)&header, sizeof(header));
+}
+
+//Function to append one record to a binary file, returns false if it doesn't fit the binary fields
+inline bool writeBinaryRecord(std::ofstream& out, const trafficRecord& record) {
+    if (record.minute < 0 || record.light < 0 || record.cars < 0 || record.cars > BINARY_MAX_CARS) return false;
+    binaryRecord binary;
+    binary.minute = (uint32_t)record.minute;
+    binary.light = (uint32_t)record.light;
+    binary.cars = (uint16_t)record.cars;
+    out.write((const char*)&binary, sizeof(binary));
+    return true;
+}
+
+//READ SECTION ------------------------------------------------------------------------------
+
+//Structure to hold an opened input file of either format
+struct trafficInput {
+    mappedFile file;
+    bool binary;
+    const binaryRecord* records;
+    std::vector<std::string_view> lines;
+    long long count;
+};
+
+//Function to open a text or binary input file
+//With index_lines a text file's lines are indexed so trafficRecordAt can be used, count is then the number of lines
+//(a binary file is always indexable, count is its number of records). Returns false if the file can't be mapped or
+//is a damaged binary file.
+inline bool openTrafficInput(trafficInput& input, const char* path, bool index_lines) {
+    input.binary = false;
+    input.records = nullptr;
+    input.lines.clear();
+    input.count = 0;
+    if (!openMappedFile(input.file, path)) return false;
+
+    if (input.file.size >= sizeof(binaryHeader) && memcmp(input.file.data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+        binaryHeader header;
+        memcpy(&header, input.file.data, sizeof(header));
+        size_t payload = input.file.size - sizeof(binaryHeader);
+        //Compared by division, a damaged record count could wrap the multiplication round to the payload size
+        if (header.version != BINARY_VERSION || payload % sizeof(binaryRecord) != 0 || header.records != payload / sizeof(binaryRecord)) {
+            closeMappedFile(input.file);
+            return false;
+        }
+        input.binary = true;
+        input.records = (const binaryRecord*)(input.file.data + sizeof(binaryHeader));
+        input.count = (long long)header.records;
+        return true;
+    }
+
+    if (index_lines) {
+        input.lines = splitLines(input.file);
+        input.count = (long long)input.lines.size();
+    }
+    return true;
+}
+
+//Function to unmap an input file
+inline void closeTrafficInput(trafficInput& input) {
+    closeMappedFile(input.file);
+    input.records = nullptr;
+    input.lines.clear();
+    input.count = 0;
+}
+
+//Function to copy a binary record into a trafficRecord
+inline void readBinaryRecord(const binaryRecord& binary, trafficRecord& record) {
+    record.minute = (int)binary.minute;
+    record.light = (int)binary.light;
+    record.cars = binary.cars;
+}
+
+//Function to read record (or line) idx of an indexed input, returns false for a malformed text line
+inline bool trafficRecordAt(const trafficInput& input, long long idx, trafficRecord& record) {
+    if (input.binary) {
+        readBinaryRecord(input.records[idx], record);
+        return true;
+    }
+    return parseTrafficRecord(input.lines[idx], record);
+}
+
+//Function to find the hour and light ranges of an input's records
+//A binary file is scanned for them (a pass at memory speed), a text file would have to be parsed so returns false.
+inline bool trafficInputRanges(const trafficInput& input, hourLightRanges& ranges) {
+    if (!input.binary || input.count == 0) return false;
+    uint32_t min_minute = UINT32_MAX, max_minute = 0, min_light = UINT32_MAX, max_light = 0;
+    for (long long i = 0; i < input.count; i++) {
+        binaryRecord record;
+        memcpy(&record, &input.records[i], sizeof(record));
+        min_minute = std::min(min_minute, record.minute);
+        max_minute = std::max(max_minute, record.minute);
+        min_light = std::min(min_light, record.light);
+        max_light = std::max(max_light, record.light);
+    }
+    if (max_minute > INT32_MAX || max_light > INT32_MAX) return false;
+    ranges = {(int)(min_minute / 60), (int)(max_minute / 60), (int)min_light, (int)max_light};
+    return true;
+}
+
+//Function to start an aggregation table for an input's records, dense when its ranges are known
+inline void initInputTable(hourLightTable& table, const trafficInput& input) {
+    hourLightRanges ranges{};
+    if (trafficInputRanges(input, ranges)) {
+        initHourLightTable(table, ranges);
+    } else {
+        initHourLightTable(table);
+    }
+}
+
+//Function to call visit on every well-formed record of the input, in file order
+template <typename Visit>
+inline void scanTrafficRecords(const trafficInput& input, Visit visit) {
+    trafficRecord record;
+    if (input.binary) {
+        for (long long i = 0; i < input.count; i++) {
+            readBinaryRecord(input.records[i], record);
+            visit(record);
+        }
+        return;
+    }
+    const char* position = input.file.data;
+    const char* data_end = input.file.data + input.file.size;
+    while (nextTrafficRecord(position, data_end, record)) {
+        visit(record);
+    }
+}
+
+#endif
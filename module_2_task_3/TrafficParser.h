@@ -0,0 +1,160 @@
+#ifndef TRAFFIC_PARSER_H
+#define TRAFFIC_PARSER_H
+
+#include <string>
+#include <string_view>
+#include <cstdio>
+#include "MappedInput.h"
+
+//Hand-written parser for "YYYY-MM-DD HH:MM:SS light cars" records.
+//The timestamp has a fixed width, so it is converted straight to a minute index (minutes since 1970-01-01 00:00)
+//with digit arithmetic instead of being split into strings. The two numbers after it are found with one 16 byte SIMD
+//compare over the end of the line, which gives the position of the space between them, and converted with a plain
+//digit loop. Lines that don't have this exact layout (tabs, repeated spaces) go through the general field splitter.
+
+//Structure to hold one parsed record
+struct trafficRecord {
+    int minute;
+    int light;
+    int cars;
+};
+
+//Length of "YYYY-MM-DD HH:MM:SS"
+const int TIMESTAMP_LENGTH = 19;
+
+//Years a minute index can hold in an int
+const int FIRST_YEAR = 1970;
+const int LAST_YEAR = 5000;
+
+//DATE SECTION ------------------------------------------------------------------------------
+
+//Function to return the days from 1970-01-01 to the given date
+inline int daysFromCivil(int year, int month, int day) {
+    year -= (month <= 2);
+    int era = year / 400;
+    int year_of_era = year - era * 400;
+    int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+//Function to turn days since 1970-01-01 back into a date
+inline void civilFromDays(int days, int& year, int& month, int& day) {
+    days += 719468;
+    int era = days / 146097;
+    int day_of_era = days - era * 146097;
+    int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    int day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int month_index = (5 * day_of_year + 2) / 153;
+    day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    month = (month_index < 10) ? month_index + 3 : month_index - 9;
+    year = year_of_era + era * 400 + (month <= 2);
+}
+
+//Function to return the number of days in a month
+inline int daysInMonth(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return days[month - 1] + (month == 2 && leap);
+}
+
+//Function to format an hour index (minute index / 60) as "YYYY-MM-DD HH"
+inline std::string formatHour(int hour_index) {
+    int year, month, day;
+    civilFromDays(hour_index / 24, year, month, day);
+    char text[48];
+    snprintf(text, sizeof(text), "%04d-%02d-%02d %02d", year, month, day, hour_index % 24);
+    return std::string(text);
+}
+
+//DIGIT SECTION -----------------------------------------------------------------------------
+
+//Function to convert length digits at text to value, returns false if any of them isn't a digit
+inline bool parseDigits(const char* text, int length, int& value) {
+    if (length < 1 || length > 9) return false;
+    int result = 0;
+    for (int i = 0; i < length; i++) {
+        unsigned digit = (unsigned char)text[i] - '0';
+        if (digit > 9) return false;
+        result = result * 10 + (int)digit;
+    }
+    value = result;
+    return true;
+}
+
+//Function to parse the fixed-width "YYYY-MM-DD" at date and "HH:MM:SS" at time into a minute index
+inline bool parseTimestampMinute(const char* date, const char* time, int& minute) {
+    if (date[4] != '-' || date[7] != '-' || time[2] != ':' || time[5] != ':') return false;
+
+    int year, month, day, hour, min, sec;
+    if (!parseDigits(date, 4, year) || !parseDigits(date + 5, 2, month) || !parseDigits(date + 8, 2, day)) return false;
+    if (!parseDigits(time, 2, hour) || !parseDigits(time + 3, 2, min) || !parseDigits(time + 6, 2, sec)) return false;
+    if (year < FIRST_YEAR || year > LAST_YEAR || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) return false;
+    if (hour > 23 || min > 59 || sec > 59) return false;
+
+    minute = (daysFromCivil(year, month, day) * 24 + hour) * 60 + min;
+    return true;
+}
+
+//LINE SECTION ------------------------------------------------------------------------------
+
+//Function to return a bit mask of the spaces in the 16 bytes at block
+inline unsigned spaceMask(const char* block) {
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128((const __m128i*)block);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < 16; i++) {
+        mask |= (unsigned)(block[i] == ' ') << i;
+    }
+    return mask;
+#endif
+}
+
+//Function to parse a line with any whitespace between its fields
+inline bool parseTrafficFields(std::string_view line, trafficRecord& record) {
+    std::string_view date, time;
+    int light, cars;
+    if (!parseTrafficLine(line, date, time, light, cars) || date.size() != 10 || time.size() != 8) return false;
+    if (!parseTimestampMinute(date.data(), time.data(), record.minute)) return false;
+    record.light = light;
+    record.cars = cars;
+    return true;
+}
+
+//Function to parse one line into record, returns false for a malformed line
+inline bool parseTrafficRecord(std::string_view line, trafficRecord& record) {
+    const char* text = line.data();
+    int size = (int)line.size();
+
+    //Fast path: one space after the timestamp and one between the numbers, found in the last 16 bytes of the line
+    if (size >= TIMESTAMP_LENGTH + 4 && text[10] == ' ' && text[TIMESTAMP_LENGTH] == ' '
+        && parseTimestampMinute(text, text + 11, record.minute)) {
+        int offset = size - 16;
+        unsigned mask = spaceMask(text + offset);
+        if (offset < TIMESTAMP_LENGTH + 1) {
+            mask &= ~0u << (TIMESTAMP_LENGTH + 1 - offset);
+        }
+        if (mask != 0 && (mask & (mask - 1)) == 0) {
+            int space = offset + __builtin_ctz(mask);
+            if (parseDigits(text + TIMESTAMP_LENGTH + 1, space - TIMESTAMP_LENGTH - 1, record.light)
+                && parseDigits(text + space + 1, size - space - 1, record.cars)) {
+                return true;
+            }
+        }
+    }
+    return parseTrafficFields(line, record);
+}
+
+//Function to parse the next well-formed record in [position, end) and move position past it
+//Malformed lines are skipped, returns false once there are no lines left.
+inline bool nextTrafficRecord(const char*& position, const char* end, trafficRecord& record) {
+    std::string_view line;
+    while (nextLine(position, end, line)) {
+        if (parseTrafficRecord(line, record)) return true;
+    }
+    return false;
+}
+
+#endif
@@ -2,15 +2,13 @@
 #include <fstream>
 #include <string>
 #include <vector>
-#include <queue>
-#include <map>
 #include <algorithm>
-#include <sstream>
 #include <mutex>
-#include <condition_variable>
 #include <atomic>
 #include <omp.h>
 #include <chrono>
+#include "TrafficInput.h"
+#include "RecordBatch.h"
 
 using namespace std;
 
@@ -35,33 +33,30 @@ string formatWithCommas(long long number)
     return result;
 }
 
-//Construct to hold traffic data
+//Construct to hold traffic data, the timestamp is a minute index
 struct TrafficData {
-    string timestamp;
+    int minute;
     int light_id;
     int cars;
 };
 
-//Main function
-int main() {
+//Main function, the optional argument is the input file (text or binary, data.txt by default)
+int main(int argc, char* argv[]) {
+    const char* input_path = (argc > 1) ? argv[1] : "data.txt";
+
     //User inputs
     int N = 5;
     vector<int> thread_counts = {2, 5, 10, 50, 100};
     vector<int> buffer_sizes = {2, 10, 50, 100, 1000};
+    vector<int> batch_sizes = {10, 50, 100, 500, 1000};
 
-    //Read all lines from data file
-    vector<string> lines;
-    ifstream in("data.txt");
-    if (!in) {
-        cout << "Error opening data.txt" << endl;
+    //Map the input file and index its text lines for the producers, nothing is copied out of the mapping
+    trafficInput in;
+    if (!openTrafficInput(in, input_path, true)) {
+        cout << "Error opening " << input_path << endl;
         return 1;
     }
-    string line;
-    while (getline(in, line)) {
-        lines.push_back(line);
-    }
-    in.close();
-    int total_lines = lines.size();
+    long long total_lines = in.count;
 
     //Output file stream
     std::ofstream out("TrafficSimulatorCombinedResults.md");
@@ -74,17 +69,11 @@ int main() {
     long long seq_total = 0;
     for (int run = 0; run < 10; ++run) {
         auto start_seq = chrono::high_resolution_clock::now();
-        map<string, map<int, int>> hour_to_light_seq;
-        for (const auto& ln : lines) {
-            string date, time, lid_str, cars_str;
-            stringstream ss(ln);
-            if (ss >> date >> time >> lid_str >> cars_str) {
-                int light = stoi(lid_str);
-                int cars = stoi(cars_str);
-                string hour = date + " " + time.substr(0,2);
-                hour_to_light_seq[hour][light] += cars;
-            }
-        }
+        hourLightTable hour_to_light_seq;
+        initInputTable(hour_to_light_seq, in);
+        scanTrafficRecords(in, [&](const trafficRecord& record) {
+            addCars(hour_to_light_seq, record.minute / 60, record.light, record.cars);
+        });
         auto end_seq = chrono::high_resolution_clock::now();
         auto elapsed_seq = chrono::duration_cast<chrono::microseconds>(end_seq - start_seq);
         seq_total += elapsed_seq.count();
@@ -93,6 +82,7 @@ int main() {
 
     //Write header
     out << "# Traffic Simulator Combined Results\n";
+    out << "**Input:** " << input_path << " (" << (in.binary ? "binary" : "text") << ", " << formatWithCommas(total_lines) << (in.binary ? " records" : " lines") << ")\n\n";
     out << "**Sequential average processing time (10 runs):** " << formatWithCommas(seq_avg) << " microseconds\n\n";
     out << "## OpenMP Results Table\n";
     out << "| Thread Count ";
@@ -108,61 +98,40 @@ int main() {
         for (int buf : buffer_sizes) {
             long long omp_total = 0;
             for (int run = 0; run < 10; ++run) {
-                queue<TrafficData> buffer;
-                mutex mtx;
-                condition_variable cv_full, cv_empty;
-                map<string, map<int, int>> hour_to_light_omp;
+                ringBuffer<TrafficData> buffer;
+                initRingBuffer(buffer, buf);
+                hourLightTable hour_to_light_omp;
                 mutex map_mtx;
-                atomic<int> current_line(0);
+                atomic<long long> current_line(0);
                 atomic<int> active_producers(threads);
 
                 //Producer function
                 auto producer = [&]() {
                     while (true) {
-                        int idx = current_line++;
+                        long long idx = current_line++;
                         if (idx >= total_lines) break;
 
-                        stringstream ss(lines[idx]);
-                        string date, time, lid_str, cars_str;
-                        if (ss >> date >> time >> lid_str >> cars_str) {
-                            TrafficData data;
-                            data.timestamp = date + " " + time;
-                            data.light_id = stoi(lid_str);
-                            data.cars = stoi(cars_str);
-
-                            unique_lock<mutex> lock(mtx);
-                            cv_full.wait(lock, [&]() { return buffer.size() < buf; });
-                            buffer.push(data);
-                            cv_empty.notify_one();
+                        trafficRecord record;
+                        if (trafficRecordAt(in, idx, record)) {
+                            TrafficData data = {record.minute, record.light, record.cars};
+                            ringPush(buffer, data);
                         }
                     }
-                    active_producers--;
-                    cv_empty.notify_all();
+                    if (--active_producers == 0) ringClose(buffer);
                 };
 
                 //Consumer function
                 auto consumer = [&]() {
-                    while (true) {
-                        TrafficData data;
-                        {
-                            unique_lock<mutex> lock(mtx);
-                            cv_empty.wait(lock, [&]() { return !buffer.empty() || active_producers == 0; });
-                            if (buffer.empty() && active_producers == 0) break;
-                            data = buffer.front();
-                            buffer.pop();
-                            cv_full.notify_one();
-                        }
-
-                        string hour = data.timestamp.substr(0, 13);
-                        {
-                            lock_guard<mutex> lock(map_mtx);
-                            hour_to_light_omp[hour][data.light_id] += data.cars;
-                        }
+                    TrafficData data;
+                    while (ringPop(buffer, data)) {
+                        lock_guard<mutex> lock(map_mtx);
+                        addCars(hour_to_light_omp, data.minute / 60, data.light_id, data.cars);
                     }
                 };
 
                 //Launch producer and consumer threads
                 auto start_omp = chrono::high_resolution_clock::now();
+                initInputTable(hour_to_light_omp, in);
                 #pragma omp parallel num_threads(threads * 2)
                 {
                     int tid = omp_get_thread_num();
@@ -192,58 +161,39 @@ int main() {
         int consumers = ratio.second;
         long long omp_total = 0;
         for (int run = 0; run < 10; ++run) {
-            queue<TrafficData> buffer;
-            mutex mtx;
-            condition_variable cv_full, cv_empty;
-            map<string, map<int, int>> hour_to_light_omp;
+            ringBuffer<TrafficData> buffer;
+            initRingBuffer(buffer, 100);
+            hourLightTable hour_to_light_omp;
             mutex map_mtx;
-            atomic<int> current_line(0);
+            atomic<long long> current_line(0);
             atomic<int> active_producers(producers);
 
             //Producer function
             auto producer = [&]() {
                 while (true) {
-                    int idx = current_line++;
+                    long long idx = current_line++;
                     if (idx >= total_lines) break;
-                    stringstream ss(lines[idx]);
-                    string date, time, lid_str, cars_str;
-                    if (ss >> date >> time >> lid_str >> cars_str) {
-                        TrafficData data;
-                        data.timestamp = date + " " + time;
-                        data.light_id = stoi(lid_str);
-                        data.cars = stoi(cars_str);
-                        unique_lock<mutex> lock(mtx);
-                        cv_full.wait(lock, [&]() { return buffer.size() < 100; });
-                        buffer.push(data);
-                        cv_empty.notify_one();
+                    trafficRecord record;
+                    if (trafficRecordAt(in, idx, record)) {
+                        TrafficData data = {record.minute, record.light, record.cars};
+                        ringPush(buffer, data);
                     }
                 }
-                active_producers--;
-                cv_empty.notify_all();
+                if (--active_producers == 0) ringClose(buffer);
             };
 
             //Consumer function
             auto consumer = [&]() {
-                while (true) {
-                    TrafficData data;
-                    {
-                        unique_lock<mutex> lock(mtx);
-                        cv_empty.wait(lock, [&]() { return !buffer.empty() || active_producers == 0; });
-                        if (buffer.empty() && active_producers == 0) break;
-                        data = buffer.front();
-                        buffer.pop();
-                        cv_full.notify_one();
-                    }
-                    string hour = data.timestamp.substr(0, 13);
-                    {
-                        lock_guard<mutex> lock(map_mtx);
-                        hour_to_light_omp[hour][data.light_id] += data.cars;
-                    }
+                TrafficData data;
+                while (ringPop(buffer, data)) {
+                    lock_guard<mutex> lock(map_mtx);
+                    addCars(hour_to_light_omp, data.minute / 60, data.light_id, data.cars);
                 }
             };
 
             //Launch producer and consumer threads
             auto start_omp = chrono::high_resolution_clock::now();
+            initInputTable(hour_to_light_omp, in);
             #pragma omp parallel num_threads(producers + consumers)
             {
                 int tid = omp_get_thread_num();
@@ -260,6 +210,89 @@ int main() {
         long long omp_avg = omp_total / 10;
         out << "| " << producers << " | " << consumers << " | " << formatWithCommas(omp_avg) << " |\n";
     }
+
+    //Batched transfer, with the buffer size of the last column of the results table (1000 records)
+    out << "\n## OpenMP Batch Size Table (Buffer Size 1000)\n";
+    out << "| Thread Count ";
+    for (int batch_size : batch_sizes) out << "| Batch Size " << batch_size << " ";
+    out << "|\n";
+    out << "|---";
+    for (size_t i = 0; i < batch_sizes.size(); ++i) out << "|---";
+    out << "|\n";
+    for (int threads : thread_counts) {
+        out << "| " << threads << " ";
+        for (int batch_size : batch_sizes) {
+            long long omp_total = 0;
+            for (int run = 0; run < 10; ++run) {
+                batchPool<TrafficData> pool;
+                initBatchPool(pool, batch_size, 1000, threads * 2);
+                hourLightTable hour_to_light_omp;
+                mutex map_mtx;
+                atomic<long long> current_line(0);
+                atomic<int> active_producers(threads);
+
+                //Producer function, claims batch_size lines at a time and queues them as one batch
+                auto producer = [&]() {
+                    int batch = acquireBatch(pool);
+                    while (true) {
+                        long long first = current_line.fetch_add(batch_size);
+                        if (first >= total_lines) break;
+                        long long last = min(first + batch_size, total_lines);
+
+                        recordBatch<TrafficData>& filling = pool.batches[batch];
+                        for (long long idx = first; idx < last; idx++) {
+                            trafficRecord record;
+                            if (trafficRecordAt(in, idx, record)) {
+                                filling.records[filling.count++] = {record.minute, record.light, record.cars};
+                            }
+                        }
+                        if (filling.count > 0) {
+                            submitBatch(pool, batch);
+                            batch = acquireBatch(pool);
+                        }
+                    }
+                    releaseBatch(pool, batch);
+                    if (--active_producers == 0) closeBatchPool(pool);
+                };
+
+                //Consumer function, adds up a whole batch under one lock
+                auto consumer = [&]() {
+                    int batch;
+                    while ((batch = receiveBatch(pool)) >= 0) {
+                        const recordBatch<TrafficData>& draining = pool.batches[batch];
+                        {
+                            lock_guard<mutex> lock(map_mtx);
+                            for (size_t i = 0; i < draining.count; i++) {
+                                const TrafficData& data = draining.records[i];
+                                addCars(hour_to_light_omp, data.minute / 60, data.light_id, data.cars);
+                            }
+                        }
+                        releaseBatch(pool, batch);
+                    }
+                };
+
+                //Launch producer and consumer threads
+                auto start_omp = chrono::high_resolution_clock::now();
+                initInputTable(hour_to_light_omp, in);
+                #pragma omp parallel num_threads(threads * 2)
+                {
+                    int tid = omp_get_thread_num();
+                    if (tid < threads) {
+                        producer();
+                    } else {
+                        consumer();
+                    }
+                }
+                auto end_omp = chrono::high_resolution_clock::now();
+                auto elapsed_omp = chrono::duration_cast<chrono::microseconds>(end_omp - start_omp);
+                omp_total += elapsed_omp.count();
+            }
+            long long omp_avg = omp_total / 10;
+            out << "| " << formatWithCommas(omp_avg) << " ";
+        }
+        out << "|\n";
+    }
     out.close();
+    closeTrafficInput(in);
     return 0;
 }
@@ -2,15 +2,13 @@
 #include <fstream>
 #include <string>
 #include <vector>
-#include <queue>
-#include <map>
 #include <algorithm>
-#include <sstream>
 #include <mutex>
-#include <condition_variable>
 #include <atomic>
 #include <omp.h>
 #include <chrono>
+#include "TrafficInput.h"
+#include "RecordBatch.h"
 
 using namespace std;
 
@@ -35,18 +33,20 @@ string formatWithCommas(long long number)
     return result;
 }
 
-//Construct to hold traffic data
+//Construct to hold traffic data, the timestamp is a minute index
 struct TrafficData {
-    string timestamp;
+    int minute;
     int light_id;
     int cars;
 };
 
 
-//Main function
-int main() {
+//Main function, the optional argument is the input file (text or binary, data.txt by default)
+int main(int argc, char* argv[]) {
+    const char* input_path = (argc > 1) ? argv[1] : "data.txt";
+
     //User inputs
-    int N, num_producers, num_consumers, buffer_size;
+    int N, num_producers, num_consumers, buffer_size, batch_size;
     cout << "Enter the number of top congested traffic lights to display per hour: ";
     cin >> N;
     cout << "Enter number of producer threads: ";
@@ -55,6 +55,8 @@ int main() {
     cin >> num_consumers;
     cout << "Enter buffer size: ";
     cin >> buffer_size;
+    cout << "Enter batch size (1 to pass records one at a time): ";
+    cin >> batch_size;
 
     //Output file stream
     std::ofstream out("TrafficSimulatorOpenMPResults.txt");
@@ -66,71 +68,90 @@ int main() {
     //Start timing
     auto start = chrono::high_resolution_clock::now();
 
-    //Read all lines from data file
-    vector<string> lines;
-    ifstream in("data.txt");
-    if (!in) {
-        out << "Error opening data.txt" << endl;
+    //Map the input file and index its text lines, nothing is copied out of the mapping
+    trafficInput in;
+    if (!openTrafficInput(in, input_path, true)) {
+        out << "Error opening " << input_path << endl;
         return 1;
     }
-    string line;
-    while (getline(in, line)) {
-        lines.push_back(line);
-    }
-    in.close();
-    int total_lines = lines.size();
+    long long total_lines = in.count;
 
     //Shared resources
-    queue<TrafficData> buffer;
-    mutex mtx;
-    condition_variable cv_full, cv_empty;
-    map<string, map<int, int>> hour_to_light;
+    ringBuffer<TrafficData> buffer;
+    initRingBuffer(buffer, buffer_size);
+    batchPool<TrafficData> pool;
+    if (batch_size > 1) initBatchPool(pool, batch_size, buffer_size, num_producers + num_consumers);
+    hourLightTable hour_to_light;
+    initInputTable(hour_to_light, in);
     mutex map_mtx;
-    atomic<int> current_line(0);
+    atomic<long long> current_line(0);
     atomic<int> active_producers(num_producers);
+    if (num_producers <= 0) {
+        ringClose(buffer);
+        closeBatchPool(pool);
+    }
 
     //Producer function
     auto producer = [&]() {
         while (true) {
-            int idx = current_line++;
+            long long idx = current_line++;
             if (idx >= total_lines) break;
 
-            stringstream ss(lines[idx]);
-            string date, time, lid_str, cars_str;
-            if (ss >> date >> time >> lid_str >> cars_str) {
-                TrafficData data;
-                data.timestamp = date + " " + time;
-                data.light_id = stoi(lid_str);
-                data.cars = stoi(cars_str);
-
-                unique_lock<mutex> lock(mtx);
-                cv_full.wait(lock, [&]() { return buffer.size() < buffer_size; });
-                buffer.push(data);
-                cv_empty.notify_one();
+            trafficRecord record;
+            if (trafficRecordAt(in, idx, record)) {
+                TrafficData data = {record.minute, record.light, record.cars};
+                ringPush(buffer, data);
             }
         }
-        active_producers--;
-        cv_empty.notify_all();
+        if (--active_producers == 0) ringClose(buffer);
     };
 
     //Consumer function
     auto consumer = [&]() {
+        TrafficData data;
+        while (ringPop(buffer, data)) {
+            lock_guard<mutex> lock(map_mtx);
+            addCars(hour_to_light, data.minute / 60, data.light_id, data.cars);
+        }
+    };
+
+    //Batched producer function, claims batch_size lines at a time and queues them as one batch
+    auto batch_producer = [&]() {
+        int batch = acquireBatch(pool);
         while (true) {
-            TrafficData data;
-            {
-                unique_lock<mutex> lock(mtx);
-                cv_empty.wait(lock, [&]() { return !buffer.empty() || active_producers == 0; });
-                if (buffer.empty() && active_producers == 0) break;
-                data = buffer.front();
-                buffer.pop();
-                cv_full.notify_one();
+            long long first = current_line.fetch_add(batch_size);
+            if (first >= total_lines) break;
+            long long last = min(first + batch_size, total_lines);
+
+            recordBatch<TrafficData>& filling = pool.batches[batch];
+            for (long long idx = first; idx < last; idx++) {
+                trafficRecord record;
+                if (trafficRecordAt(in, idx, record)) {
+                    filling.records[filling.count++] = {record.minute, record.light, record.cars};
+                }
             }
+            if (filling.count > 0) {
+                submitBatch(pool, batch);
+                batch = acquireBatch(pool);
+            }
+        }
+        releaseBatch(pool, batch);
+        if (--active_producers == 0) closeBatchPool(pool);
+    };
 
-            string hour = data.timestamp.substr(0, 13); 
+    //Batched consumer function, adds up a whole batch under one lock
+    auto batch_consumer = [&]() {
+        int batch;
+        while ((batch = receiveBatch(pool)) >= 0) {
+            const recordBatch<TrafficData>& draining = pool.batches[batch];
             {
                 lock_guard<mutex> lock(map_mtx);
-                hour_to_light[hour][data.light_id] += data.cars;
+                for (size_t i = 0; i < draining.count; i++) {
+                    const TrafficData& data = draining.records[i];
+                    addCars(hour_to_light, data.minute / 60, data.light_id, data.cars);
+                }
             }
+            releaseBatch(pool, batch);
         }
     };
 
@@ -139,33 +160,28 @@ int main() {
     {
         int tid = omp_get_thread_num();
         if (tid < num_producers) {
-            producer();
+            if (batch_size > 1) batch_producer(); else producer();
         } else {
-            consumer();
+            if (batch_size > 1) batch_consumer(); else consumer();
         }
     }
 
     //Stop timing
     auto end = chrono::high_resolution_clock::now();
     auto elapsed = chrono::duration_cast<chrono::microseconds>(end - start);
+    closeTrafficInput(in);
 
     //Output results
-    for (auto& hour_entry : hour_to_light) {
-        string hour = hour_entry.first;
-        auto& lights = hour_entry.second;
-
-        vector<pair<int, int>> vec; 
-        for (auto& p : lights) {
-            vec.push_back({p.second, p.first});
-        }
-        sort(vec.rbegin(), vec.rend()); 
+    forEachHour(hour_to_light, [&](int hour_index, vector<pair<long long, int>>& vec) {
+        string hour = formatHour(hour_index);
+        sort(vec.rbegin(), vec.rend());
 
         out << "Top " << N << " congested lights for hour " << hour << ":" << endl;
         for (int i = 0; i < min(N, (int)vec.size()); i++) {
             out << "  Light " << vec[i].second << ": " << vec[i].first << " cars" << endl;
         }
         out << endl;
-    }
+    });
 
     out << "Processing time: " << formatWithCommas(elapsed.count()) << " microseconds" << endl;
     out.close();
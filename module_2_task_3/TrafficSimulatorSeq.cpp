@@ -1,11 +1,10 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <map>
 #include <vector>
 #include <algorithm>
-#include <sstream>
 #include <chrono>
+#include "TrafficInput.h"
 
 using namespace std;
 
@@ -31,8 +30,10 @@ string formatWithCommas(long long number)
 }
 
 
-//Main function
-int main() {
+//Main function, the optional argument is the input file (text or binary, data.txt by default)
+int main(int argc, char* argv[]) {
+    const char* input_path = (argc > 1) ? argv[1] : "data.txt";
+
     //User inputs
     int N;
     cout << "Enter the number of top congested traffic lights to display per hour: ";
@@ -48,51 +49,38 @@ int main() {
     //Start timing
     auto start = chrono::high_resolution_clock::now();
 
-    //Read all lines from data file
-    ifstream in("data.txt");
-    if (!in) {
-        out << "Error opening data.txt" << endl;
+    //Map the input file, text lines are parsed in place on the mapped pages
+    trafficInput in;
+    if (!openTrafficInput(in, input_path, false)) {
+        out << "Error opening " << input_path << endl;
         return 1;
     }
 
-    //Store lines in vector
-    map<string, map<int, int>> hour_to_light;
-
-    //Process each line
-    string line;
-    while (getline(in, line)) {
-        string date, time, lid_str, cars_str;
-        stringstream ss(line);
-        if (ss >> date >> time >> lid_str >> cars_str) {
-            int light = stoi(lid_str);
-            int cars = stoi(cars_str);
-            string hour = date + " " + time.substr(0,2); 
-            hour_to_light[hour][light] += cars;
-        }
-    }
-    in.close();
+    //Cars per light for each hour (minute index / 60)
+    hourLightTable hour_to_light;
+    initInputTable(hour_to_light, in);
+
+    //Process each record
+    scanTrafficRecords(in, [&](const trafficRecord& record) {
+        addCars(hour_to_light, record.minute / 60, record.light, record.cars);
+    });
+    closeTrafficInput(in);
 
     //Stop timing
     auto end = chrono::high_resolution_clock::now();
     auto elapsed = chrono::duration_cast<chrono::microseconds>(end - start);
 
     //Output results
-    for (auto& hour_entry : hour_to_light) {
-        string hour = hour_entry.first;
-        auto& lights = hour_entry.second;
-
-        vector<pair<int, int>> vec; 
-        for (auto& p : lights) {
-            vec.push_back({p.second, p.first});
-        }
-        sort(vec.rbegin(), vec.rend()); 
+    forEachHour(hour_to_light, [&](int hour_index, vector<pair<long long, int>>& vec) {
+        string hour = formatHour(hour_index);
+        sort(vec.rbegin(), vec.rend());
 
         out << "Top " << N << " congested lights for hour " << hour << ":" << endl;
         for (int i = 0; i < min(N, (int)vec.size()); i++) {
             out << "  Light " << vec[i].second << ": " << vec[i].first << " cars" << endl;
         }
         out << endl;
-    }
+    });
 
     out << "Processing time: " << formatWithCommas(elapsed.count()) << " microseconds" << endl;
     out.close();
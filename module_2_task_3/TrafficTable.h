@@ -0,0 +1,203 @@
+#ifndef TRAFFIC_TABLE_H
+#define TRAFFIC_TABLE_H
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+//Aggregation table for the cars per (hour index, light ID), replacing the nested map<..., map<int, int>>.
+//When the ranges of hours and lights are known up front the cells are a dense 2D array and adding a record is one
+//index calculation. Otherwise (and for any record outside the known ranges) the cells go in an open-addressing hash
+//table with linear probing, keyed by the hour and light packed into one 64 bit integer. Neither allocates per record.
+
+//CONFIGURATION SECTION ---------------------------------------------------------------------
+
+//Largest dense table, bigger ranges use the hash table
+const long long DENSE_TABLE_MAX_CELLS = 1LL << 26;
+
+//Initial number of hash table slots (a power of two)
+const size_t HASH_TABLE_INITIAL_SLOTS = 1024;
+
+//Key of an empty hash table slot (hour -1, light -1)
+const uint64_t EMPTY_SLOT = ~0ULL;
+
+//TABLE SECTION -----------------------------------------------------------------------------
+
+//Structure to hold the hour index and light ID ranges of some records (inclusive)
+struct hourLightRanges {
+    int first_hour, last_hour;
+    int first_light, last_light;
+};
+
+//Structure to hold a dense table of the cells in a known range
+struct denseTable {
+    int first_hour, hours;
+    int first_light, lights;
+    std::vector<long long> cars;
+    std::vector<char> present;
+};
+
+//Structure to hold an open-addressing hash table
+struct flatTable {
+    std::vector<uint64_t> keys;
+    std::vector<long long> cars;
+    size_t used;
+    int shift;
+};
+
+//Structure to hold the aggregation table: the dense cells (if any) and the hash table for everything else
+struct hourLightTable {
+    bool dense;
+    denseTable grid;
+    flatTable hash;
+};
+
+//Function to empty a hash table
+inline void initFlatTable(flatTable& hash) {
+    hash.keys.assign(HASH_TABLE_INITIAL_SLOTS, EMPTY_SLOT);
+    hash.cars.assign(HASH_TABLE_INITIAL_SLOTS, 0);
+    hash.used = 0;
+    hash.shift = 64 - __builtin_ctzll(HASH_TABLE_INITIAL_SLOTS);
+}
+
+//Function to start an aggregation table with unknown ranges, every cell goes in the hash table
+inline void initHourLightTable(hourLightTable& table) {
+    table.dense = false;
+    table.grid = denseTable();
+    initFlatTable(table.hash);
+}
+
+//Function to start an aggregation table whose cells are expected in ranges, dense if the ranges are small enough
+inline void initHourLightTable(hourLightTable& table, const hourLightRanges& ranges) {
+    initHourLightTable(table);
+    long long hours = (long long)ranges.last_hour - ranges.first_hour + 1;
+    long long lights = (long long)ranges.last_light - ranges.first_light + 1;
+    if (hours < 1 || lights < 1 || hours * lights > DENSE_TABLE_MAX_CELLS) return;
+
+    table.dense = true;
+    table.grid.first_hour = ranges.first_hour;
+    table.grid.hours = (int)hours;
+    table.grid.first_light = ranges.first_light;
+    table.grid.lights = (int)lights;
+    table.grid.cars.assign(hours * lights, 0);
+    table.grid.present.assign(hours * lights, 0);
+}
+
+//HASH SECTION ------------------------------------------------------------------------------
+
+//Function to pack an hour and a light into a hash key
+inline uint64_t hourLightKey(int hour, int light) {
+    return ((uint64_t)(uint32_t)hour << 32) | (uint32_t)light;
+}
+
+//Function to return the first slot to probe for key
+inline size_t hashSlot(const flatTable& hash, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> hash.shift);
+}
+
+//Function to double the hash table and reinsert its cells
+inline void growFlatTable(flatTable& hash) {
+    std::vector<uint64_t> old_keys;
+    std::vector<long long> old_cars;
+    old_keys.swap(hash.keys);
+    old_cars.swap(hash.cars);
+
+    size_t slots = old_keys.size() * 2;
+    hash.keys.assign(slots, EMPTY_SLOT);
+    hash.cars.assign(slots, 0);
+    hash.shift--;
+    for (size_t i = 0; i < old_keys.size(); i++) {
+        if (old_keys[i] == EMPTY_SLOT) continue;
+        size_t slot = hashSlot(hash, old_keys[i]);
+        while (hash.keys[slot] != EMPTY_SLOT) slot = (slot + 1) & (slots - 1);
+        hash.keys[slot] = old_keys[i];
+        hash.cars[slot] = old_cars[i];
+    }
+}
+
+//Function to add cars to a cell of the hash table
+inline void addHashCars(flatTable& hash, int hour, int light, int cars) {
+    uint64_t key = hourLightKey(hour, light);
+    size_t mask = hash.keys.size() - 1;
+    size_t slot = hashSlot(hash, key);
+    while (hash.keys[slot] != key) {
+        if (hash.keys[slot] == EMPTY_SLOT) {
+            //Kept at most 70% full so probe runs stay short
+            if ((hash.used + 1) * 10 > hash.keys.size() * 7) {
+                growFlatTable(hash);
+                addHashCars(hash, hour, light, cars);
+                return;
+            }
+            hash.keys[slot] = key;
+            hash.used++;
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    hash.cars[slot] += cars;
+}
+
+//ACCESS SECTION ----------------------------------------------------------------------------
+
+//Function to add a record's cars to its (hour, light) cell
+inline void addCars(hourLightTable& table, int hour, int light, int cars) {
+    if (table.dense) {
+        unsigned row = (unsigned)(hour - table.grid.first_hour);
+        unsigned column = (unsigned)(light - table.grid.first_light);
+        if (row < (unsigned)table.grid.hours && column < (unsigned)table.grid.lights) {
+            size_t cell = (size_t)row * table.grid.lights + column;
+            table.grid.cars[cell] += cars;
+            table.grid.present[cell] = 1;
+            return;
+        }
+    }
+    addHashCars(table.hash, hour, light, cars);
+}
+
+//Function to call visit(hour, lights) for every hour with records, in hour order
+//lights holds a (cars, light ID) pair for every light of the hour, in light order.
+template <typename Visit>
+inline void forEachHour(const hourLightTable& table, Visit visit) {
+    //Hash table cells sorted by key are sorted by hour and then light
+    std::vector<std::pair<uint64_t, long long>> cells;
+    cells.reserve(table.hash.used);
+    for (size_t i = 0; i < table.hash.keys.size(); i++) {
+        if (table.hash.keys[i] != EMPTY_SLOT) cells.push_back({table.hash.keys[i], table.hash.cars[i]});
+    }
+    std::sort(cells.begin(), cells.end());
+
+    std::vector<std::pair<long long, int>> lights;
+    size_t next = 0;
+    int dense_hours = table.dense ? table.grid.hours : 0;
+    int row = 0;
+    while (row < dense_hours || next < cells.size()) {
+        int dense_hour = (row < dense_hours) ? table.grid.first_hour + row : 0;
+        int hash_hour = (next < cells.size()) ? (int)(cells[next].first >> 32) : 0;
+        bool from_dense = row < dense_hours && (next >= cells.size() || dense_hour <= hash_hour);
+        bool from_hash = next < cells.size() && (row >= dense_hours || hash_hour <= dense_hour);
+        int hour = from_dense ? dense_hour : hash_hour;
+
+        lights.clear();
+        if (from_dense) {
+            size_t start = (size_t)row * table.grid.lights;
+            for (int column = 0; column < table.grid.lights; column++) {
+                if (table.grid.present[start + column]) {
+                    lights.push_back({table.grid.cars[start + column], table.grid.first_light + column});
+                }
+            }
+            row++;
+        }
+        if (from_hash) {
+            size_t dense_lights = lights.size();
+            for (; next < cells.size() && (int)(cells[next].first >> 32) == hour; next++) {
+                lights.push_back({cells[next].second, (int)(uint32_t)cells[next].first});
+            }
+            std::inplace_merge(lights.begin(), lights.begin() + dense_lights, lights.end(),
+                               [](const std::pair<long long, int>& a, const std::pair<long long, int>& b) { return a.second < b.second; });
+        }
+        if (!lights.empty()) visit(hour, lights);
+    }
+}
+
+#endif
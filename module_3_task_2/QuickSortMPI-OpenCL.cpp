@@ -7,8 +7,11 @@
 #include <fstream>
 #include <vector>
 #include <stack>
+#include <climits>
 #include <mpi.h>
 #include <CL/cl.h>
+#include "../module_2_task_2/SortEngine.h"
+#include "../module_2_task_2/SortVerify.h"
 
 using namespace std::chrono;
 using namespace std;
@@ -46,9 +49,9 @@ string formatWithCommas(long long number)
 }
 
 //Function to initialize array with random values
-void initializeArray(int array[], int size)
+void initializeArray(int array[], long long size)
 {
-    for (int i = 0; i < size; i++)
+    for (long long i = 0; i < size; i++)
     {
         array[i] = rand();
     }
@@ -63,27 +66,9 @@ string getOpenCLDeviceName(cl_device_id device) {
     return name_str;
 }
 
-//Standard sequential QuickSort partition function
-int partitionCPU(int arr[], int low, int high) {
-    int pivot = arr[high];
-    int i = (low - 1);
-    for (int j = low; j <= high - 1; j++) {
-        if (arr[j] <= pivot) {
-            i++;
-            swap(arr[i], arr[j]);
-        }
-    }
-    swap(arr[i + 1], arr[high]);
-    return (i + 1);
-}
-
-//Sequential QuickSort for small sub-arrays
-void quickSortCPU(int arr[], int low, int high) {
-    if (low < high) {
-        int pi = partitionCPU(arr, low, high);
-        quickSortCPU(arr, low, pi - 1);
-        quickSortCPU(arr, pi + 1, high);
-    }
+//Sequential QuickSort for small sub-arrays, backed by the introsort engine shared with module_2_task_2
+void quickSortCPU(int arr[], long long low, long long high) {
+    introSort(arr, low, high);
 }
 
 
@@ -195,18 +180,28 @@ int main(int argc, char* argv[])
              }
              continue;
         }
+        // MPI counts and the kernel's low / high are int, so each process can hold at most INT_MAX elements
+        if (size / world_size > INT_MAX) {
+            if (rank == 0) {
+                cout << "MPI+OpenCL QuickSort (Processes: " << world_size << ", Device: " << deviceName << ", size " << formatWithCommas(size) << "): SKIPPED (too many elements per process)" << endl;
+            }
+            continue;
+        }
 
         if (rank == 0) {
             cout << "Testing array size: " << formatWithCommas(size) << endl;
         }
         
         long long total_duration = 0;
+        int failed_runs = 0;
         int* array = nullptr;
 
         for (int run = 0; run < 10; ++run) {
+            unsigned long long input_hash = 0;
             if (rank == 0) {
                 array = new int[size];
                 initializeArray(array, size);
+                input_hash = multisetHash(array, size);
             }
 
             int local_size = size / world_size;
@@ -227,6 +222,8 @@ int main(int argc, char* argv[])
 
             if (rank == 0) {
                 total_duration += duration_cast<microseconds>(stop - start).count();
+                // Every run is checked (not timed), since racy swaps in the partition kernel can lose or duplicate elements
+                failed_runs += !verifySortedPermutation(array, size, input_hash);
                 if(array) delete[] array;
             }
             delete[] local_array;
@@ -235,6 +232,9 @@ int main(int argc, char* argv[])
         if (rank == 0) {
             long long avg_time = total_duration / NUM_RUNS;
             cout << "MPI+OpenCL QuickSort (Processes: " << world_size << ", Device: " << deviceName << ", size " << formatWithCommas(size) << "): " << formatWithCommas(avg_time) << " microseconds" << endl;
+            if (failed_runs > 0) {
+                cout << "Array was not sorted correctly in " << failed_runs << " of " << NUM_RUNS << " runs." << endl;
+            }
         }
     }
     